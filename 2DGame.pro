@@ -9,28 +9,70 @@ CONFIG += c++17
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    Animation.cpp \
     AttackEffect.cpp \
     BallProjectile.cpp \
+    BatchRunner.cpp \
+    BotController.cpp \
+    BotSearch.cpp \
     Bullet.cpp \
     Character.cpp \
     GameOverScreen.cpp \
     GameScreen.cpp \
+    HeapCounter.cpp \
     HelpScreen.cpp \
+    HitTest.cpp \
     Item.cpp \
     KnifeAttackEffect.cpp \
+    LatencyProbe.cpp \
+    Level.cpp \
+    MatchSnapshot.cpp \
+    MemoryStats.cpp \
+    ParticleSystem.cpp \
+    Simulation.cpp \
+    SimulationThread.cpp \
+    StressTest.cpp \
+    Telemetry.cpp \
+    TelemetryAnalytics.cpp \
+    TickArena.cpp \
+    TileRenderer.cpp \
     main.cpp
 
 HEADERS += \
+    Animation.h \
     AttackEffect.h \
     BallProjectile.h \
+    BatchRunner.h \
+    BotController.h \
+    BotSearch.h \
     Bullet.h \
     Character.h \
     GameOverScreen.h \
     GameScreen.h \
+    HeapCounter.h \
     HelpScreen.h \
+    HitTest.h \
+    InputState.h \
     Item.h \
     KnifeAttackEffect.h \
-    Platform.h
+    LatencyProbe.h \
+    Level.h \
+    MatchSnapshot.h \
+    MemoryStats.h \
+    ParticleSystem.h \
+    Platform.h \
+    Simulation.h \
+    SimulationThread.h \
+    SpscQueue.h \
+    StressTest.h \
+    Telemetry.h \
+    TelemetryAnalytics.h \
+    TickArena.h \
+    TileRenderer.h \
+    TripleBuffer.h
+
+# 统计全局堆分配（替换 operator new/delete，在 F5 帧统计中显示）：qmake CONFIG+=heap_counter
+heap_counter: DEFINES += HEAP_COUNTER
 
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
@@ -39,3 +81,22 @@ else: unix:!android: target.path = /opt/$${TARGET}/bin
 
 RESOURCES += \
     resources.qrc
+
+# 关卡文件：构建时编译为二进制（levels/*.lvb，放在可执行文件旁）
+LEVELS += \
+    levels/classic.lvl \
+    levels/wide.lvl
+
+win32: LEVELC_PYTHON = python
+else: LEVELC_PYTHON = python3
+
+levelc.input = LEVELS
+levelc.output = $$OUT_PWD/levels/${QMAKE_FILE_BASE}.lvb
+levelc.commands = $$LEVELC_PYTHON $$PWD/tools/levelc.py ${QMAKE_FILE_IN} ${QMAKE_FILE_OUT}
+levelc.depends = $$PWD/tools/levelc.py
+levelc.CONFIG += no_link target_predeps
+QMAKE_EXTRA_COMPILERS += levelc
+
+DISTFILES += \
+    $$LEVELS \
+    tools/levelc.py
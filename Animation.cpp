@@ -0,0 +1,143 @@
+#include "Animation.h"
+#include <algorithm>
+#include <sstream>
+
+bool AnimationLibrary::parse(const std::string& text, std::string* error) {
+    auto fail = [error](int lineNumber, const std::string& message) {
+        if (error) *error = "第" + std::to_string(lineNumber) + "行: " + message;
+        return false;
+    };
+
+    std::map<std::string, AnimationClip> parsed;
+    AnimationClip* clip = nullptr;
+    std::istringstream in(text);
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        std::istringstream row(line);
+        std::string directive;
+        if (!(row >> directive) || directive[0] == '#') continue;
+
+        if (directive == "clip") {
+            std::string name, loop;
+            if (!(row >> name >> loop)) return fail(lineNumber, "clip 需要名称和播放方式");
+            clip = &parsed[name];
+            clip->name = name;
+            if (loop == "once") clip->loop = AnimationClip::ONCE;
+            else if (loop == "loop") clip->loop = AnimationClip::LOOP;
+            else if (loop == "hold") clip->loop = AnimationClip::HOLD;
+            else return fail(lineNumber, "未知播放方式 " + loop);
+        } else if (directive == "cell" || directive == "image") {
+            if (!clip) return fail(lineNumber, "帧必须位于 clip 之后");
+            AnimationFrame frame;
+            bool ok = directive == "cell" ? static_cast<bool>(row >> frame.column >> frame.row >> frame.durationMs)
+                                          : static_cast<bool>(row >> frame.image >> frame.durationMs);
+            if (!ok || frame.durationMs <= 0) return fail(lineNumber, "帧格式错误");
+            clip->frames.push_back(frame);
+            clip->lengthMs += frame.durationMs;
+        } else if (directive == "event") {
+            std::string name;
+            if (!clip || clip->frames.empty() || !(row >> name)) return fail(lineNumber, "event 必须位于帧之后");
+            clip->frames.back().events.push_back(name);
+        } else {
+            return fail(lineNumber, "未知指令 " + directive);
+        }
+    }
+
+    for (const auto& entry : parsed) {
+        if (entry.second.frames.empty()) return fail(lineNumber, "片段 " + entry.first + " 没有帧");
+    }
+    clipsByName.swap(parsed);
+    return true;
+}
+
+const AnimationClip* AnimationLibrary::find(const std::string& name) const {
+    auto it = clipsByName.find(name);
+    return it == clipsByName.end() ? nullptr : &it->second;
+}
+
+Animator::Handle Animator::create() {
+    Handle handle;
+    if (!freeHandles.empty()) {
+        handle = freeHandles.back();
+        freeHandles.pop_back();
+    } else {
+        handle = static_cast<Handle>(players.size());
+        players.emplace_back();
+    }
+    players[handle] = AnimationPlayer();
+    players[handle].active = true;
+    return handle;
+}
+
+void Animator::release(Handle handle) {
+    players[handle] = AnimationPlayer();
+    freeHandles.push_back(handle);
+}
+
+void Animator::play(Handle handle, const AnimationClip* clip) {
+    AnimationPlayer& p = players[handle];
+    p.clip = clip;
+    p.frame = 0;
+    p.timeMs = 0;
+    p.finished = !clip;
+    if (clip) enterFrame(p);
+}
+
+void Animator::switchTo(Handle handle, const AnimationClip* clip) {
+    AnimationPlayer& p = players[handle];
+    if (p.clip == clip) return;
+    if (!p.clip || !clip) {
+        play(handle, clip);
+        return;
+    }
+    p.clip = clip;
+    p.frame %= static_cast<int>(clip->frames.size());
+    p.timeMs = std::min(p.timeMs, clip->frames[p.frame].durationMs - 1);
+}
+
+void Animator::stop(Handle handle) {
+    AnimationPlayer& p = players[handle];
+    p.clip = nullptr;
+    p.frame = 0;
+    p.timeMs = 0;
+    p.finished = true;
+}
+
+void Animator::enterFrame(AnimationPlayer& p) {
+    if (!p.listener) return;
+    for (const std::string& event : p.clip->frames[p.frame].events) p.listener(event);
+}
+
+void Animator::step(int ms) {
+    // 先推进全部实例再触发事件，回调中可以安全地创建或切换动画
+    entered.clear();
+    for (size_t i = 0; i < players.size(); i++) {
+        AnimationPlayer& p = players[i];
+        if (!p.active || !p.clip || p.finished) continue;
+
+        const std::vector<AnimationFrame>& frames = p.clip->frames;
+        p.timeMs += ms;
+        while (p.timeMs >= frames[p.frame].durationMs) {
+            p.timeMs -= frames[p.frame].durationMs;
+            if (p.frame + 1 < static_cast<int>(frames.size())) {
+                p.frame++;
+            } else if (p.clip->loop == AnimationClip::LOOP) {
+                p.frame = 0;
+            } else {
+                p.finished = true;
+                p.timeMs = 0;
+                break;
+            }
+            if (!frames[p.frame].events.empty()) entered.push_back({static_cast<Handle>(i), &frames[p.frame]});
+        }
+    }
+
+    for (const auto& entry : entered) {
+        const AnimationPlayer& p = players[entry.first];
+        if (!p.listener) continue;
+        std::function<void(const std::string&)> listener = p.listener;
+        for (const std::string& event : entry.second->events) listener(event);
+    }
+}
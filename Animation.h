@@ -0,0 +1,101 @@
+#ifndef ANIMATION_H
+#define ANIMATION_H
+
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+// 动画帧：精灵图中的一格（列、行）或一张独立图片
+struct AnimationFrame {
+    int column = 0;
+    int row = 0;
+    std::string image;          // 非空时使用独立图片
+    int durationMs = 0;
+    std::vector<std::string> events; // 进入该帧时触发的事件
+};
+
+// 动画片段
+struct AnimationClip {
+    enum Loop {
+        ONCE,   // 播放一次后结束
+        LOOP,   // 循环播放
+        HOLD    // 播放一次后停在最后一帧
+    };
+
+    std::string name;
+    Loop loop = LOOP;
+    std::vector<AnimationFrame> frames;
+    int lengthMs = 0;           // 各帧时长之和
+};
+
+// 动画数据（res/animations.txt），格式：
+//   clip <名称> once|loop|hold
+//   cell <列> <行> <毫秒>         精灵图中的一格
+//   image <路径> <毫秒>           独立图片
+//   event <名称>                  进入上一帧时触发
+// # 开头为注释
+class AnimationLibrary {
+public:
+    bool parse(const std::string& text, std::string* error = nullptr);
+
+    // 未知名称返回空
+    const AnimationClip* find(const std::string& name) const;
+
+    const std::map<std::string, AnimationClip>& clips() const { return clipsByName; }
+
+private:
+    std::map<std::string, AnimationClip> clipsByName;
+};
+
+// 一个动画实例的播放进度
+struct AnimationPlayer {
+    const AnimationClip* clip = nullptr;
+    int timeMs = 0;             // 当前帧已播放的时间
+    int frame = 0;
+    bool finished = false;      // ONCE 播放完毕（HOLD 停在最后一帧时也为 true）
+    bool active = false;        // 是否占用
+    std::function<void(const std::string&)> listener; // 帧事件回调
+
+    const AnimationFrame* currentFrame() const {
+        if (!clip || clip->frames.empty()) return nullptr;
+        return &clip->frames[frame];
+    }
+};
+
+// 所有动画实例集中存放，由主模拟时钟统一推进：每个模拟帧一次遍历
+class Animator {
+public:
+    using Handle = int;
+
+    Handle create();
+    void release(Handle handle);
+
+    // 从头播放
+    void play(Handle handle, const AnimationClip* clip);
+
+    // 切换片段并保留播放进度（例如行走中转身）
+    void switchTo(Handle handle, const AnimationClip* clip);
+
+    void stop(Handle handle);
+
+    // 推进所有动画，并触发经过的帧事件
+    void step(int ms);
+
+    AnimationPlayer& player(Handle handle) { return players[handle]; }
+    const AnimationPlayer& player(Handle handle) const { return players[handle]; }
+
+    // 使用中的实例数和已分配的实例数（释放的编号留待复用）
+    int liveCount() const { return static_cast<int>(players.size() - freeHandles.size()); }
+    int capacity() const { return static_cast<int>(players.capacity()); }
+
+private:
+    void enterFrame(AnimationPlayer& p);
+
+    std::vector<AnimationPlayer> players;
+    std::vector<Handle> freeHandles;
+    std::vector<std::pair<Handle, const AnimationFrame*>> entered; // 本次推进进入的带事件帧
+};
+
+#endif // ANIMATION_H
@@ -1,10 +1,15 @@
 #include "AttackEffect.h"
 
-AttackEffect::AttackEffect(QWidget *parent) : QWidget(parent) {
+AttackEffect::AttackEffect(Animator *animator, const AnimationLibrary *animations, QWidget *parent)
+    : QWidget(parent), animator(animator) {
     setAttribute(Qt::WA_TransparentForMouseEvents);
     setAttribute(Qt::WA_NoSystemBackground);
-    animationTimer = new QTimer(this);
-    connect(animationTimer, &QTimer::timeout, this, &AttackEffect::updateFrame);
+    clips[0] = animations->find("fist_hit_left");
+    clips[1] = animations->find("fist_hit_right");
+    animation = animator->create();
+    animator->player(animation).listener = [this](const std::string &name) {
+        emit animationEvent(QString::fromStdString(name));
+    };
 }
 
 void AttackEffect::startAttack(bool isRight, int characterX, int characterY, int characterWidth, int characterHeight) {
@@ -28,46 +33,57 @@ void AttackEffect::startAttack(bool isRight, int characterX, int characterY, int
     int posY = characterY + (characterHeight - effectHeight)/2 + characterHeight * 0.2;
     move(posX, posY);
 
-    // 加载动画帧
+    // 加载动画帧并从头播放
     loadFrames();
-
-    // 启动动画定时器
-    animationTimer->start(50); // 20 FPS
+    animator->play(animation, clips[directionRight ? 1 : 0]);
     show();
 }
 
+// 帧图片按片段缓存，尺寸变化时重新缩放
 void AttackEffect::loadFrames() {
-    frames.clear();
-    QString basePath = directionRight ?
-                           ":/new/prefix1/res/sm_gs_superskill1_45_hit_%1.png" :
-                           ":/new/prefix1/res/sm_gs_superskill1_225_hit_%1.png";
+    const AnimationClip *clip = clips[directionRight ? 1 : 0];
+    frames = nullptr;
+    if (!clip) return;
 
-    for (int i = 1; i <= 10; i++) {
-        QString path = basePath.arg(i, 4, 10, QChar('0'));
-        QPixmap frame(path);
-        if (!frame.isNull()) {
-            frames.append(frame.scaled(size(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+    QVector<QPixmap> &cached = frameCache[clip];
+    if (cached.isEmpty() || cached.first().size() != size()) {
+        cached.clear();
+        for (const AnimationFrame &frame : clip->frames) {
+            QPixmap pixmap(QString::fromStdString(frame.image));
+            if (!pixmap.isNull()) pixmap = pixmap.scaled(size(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+            cached.append(pixmap);
         }
     }
+    frames = &cached;
 }
 
-void AttackEffect::paintEvent(QPaintEvent *event) {
-    Q_UNUSED(event);
-    if (!visible || frames.isEmpty()) return;
-    if (currentFrame >= frames.size()) return;
-
-    QPainter painter(this);
-    painter.setRenderHint(QPainter::SmoothPixmapTransform);
-    painter.drawPixmap(0, 0, frames[currentFrame]);
+void AttackEffect::reportMemory(MemoryStats &stats) const {
+    for (auto it = frameCache.constBegin(); it != frameCache.constEnd(); ++it) {
+        const QVector<QPixmap> &cached = it.value();
+        for (int i = 0; i < cached.size() && i < static_cast<int>(it.key()->frames.size()); i++) {
+            stats.addPixmap(QString::fromStdString(it.key()->frames[i].image), cached[i]);
+        }
+    }
 }
 
-void AttackEffect::updateFrame() {
-    currentFrame++;
-    if (currentFrame >= frames.size()) {
-        animationTimer->stop();
+void AttackEffect::syncAnimation() {
+    if (!visible) return;
+    const AnimationPlayer &player = animator->player(animation);
+    if (player.finished) {
         visible = false;
         hide();
-    } else {
+    } else if (player.frame != currentFrame) {
+        currentFrame = player.frame;
         update();
     }
 }
+
+void AttackEffect::paintEvent(QPaintEvent *event) {
+    Q_UNUSED(event);
+    if (!visible || !frames) return;
+    if (currentFrame >= frames->size() || (*frames)[currentFrame].isNull()) return;
+
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    painter.drawPixmap(0, 0, (*frames)[currentFrame]);
+}
@@ -5,13 +5,15 @@
 #include <QVector>
 #include <QPixmap>
 #include <QPainter>
-#include <QTimer>
+#include <QHash>
+#include "Animation.h"
+#include "MemoryStats.h"
 
-// 攻击特效类 - 已修改为拳头特效
-class AttackEffect : public QWidget {
+// 攻击特效类 - 已修改为拳头特效，帧序列和时长来自动画数据
+class AttackEffect : public QWidget, public MemoryReporter {
     Q_OBJECT
 public:
-    AttackEffect(QWidget *parent = nullptr);
+    AttackEffect(Animator *animator, const AnimationLibrary *animations, QWidget *parent = nullptr);
 
     // 开始攻击动画 - 已修改为拳头攻击
     void startAttack(bool isRight, int characterX, int characterY, int characterWidth, int characterHeight);
@@ -19,18 +21,27 @@ public:
     // 加载动画帧 - 已修改为使用拳头资源
     void loadFrames();
 
+    // 根据动画进度刷新显示，播放完毕后隐藏（每次绘制前调用）
+    void syncAnimation();
+
     // 是否可见
     bool isVisible() const { return visible; }
 
+    // 已缓存的各片段帧图片
+    void reportMemory(MemoryStats &stats) const override;
+
+signals:
+    void animationEvent(const QString &name); // 动画帧事件（如 impact）
+
 protected:
     void paintEvent(QPaintEvent *event) override;
 
-private slots:
-    void updateFrame();
-
 private:
-    QVector<QPixmap> frames;
-    QTimer *animationTimer;
+    Animator *animator;
+    Animator::Handle animation;
+    const AnimationClip *clips[2];                           // 0=向左, 1=向右
+    QHash<const AnimationClip*, QVector<QPixmap>> frameCache; // 缩放后的帧图片
+    QVector<QPixmap> *frames = nullptr;
     int currentFrame = 0;
     bool visible = false;
     bool directionRight = true;
@@ -0,0 +1,364 @@
+#include "BatchRunner.h"
+#include "BotSearch.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+namespace {
+// 每局种子由基础种子和对局编号派生（splitmix64）
+uint64_t matchSeed(uint64_t base, int index) {
+    uint64_t z = base + 0x9E3779B97F4A7C15ull * static_cast<uint64_t>(index + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+const char* WEAPON_NAMES[SimCharacter::WEAPON_COUNT] = { "fist", "knife", "ball", "rifle", "sniper" };
+const char* ITEM_NAMES[SimItem::TYPE_COUNT] = {
+    "bandage", "medkit", "adrenaline", "knife", "ball", "rifle", "sniper", "light_armor", "bulletproof_vest"
+};
+
+void printUsage() {
+    std::fprintf(stderr,
+                 "用法: 2DGame --batch [--matches N] [--seed S] [--threads N]\n"
+                 "                     [--policy scripted|bot|mixed] [--difficulty 0-2]\n"
+                 "                     [--level classic|wide] [--players 2-8] [--teams N]\n"
+                 "                     [--sim-hz 20-240] [--max-seconds N] [--out results.csv]\n"
+                 "      2DGame --replay latency_replay.csv [--latency-out latency.csv] [--max-p95-ms N]\n");
+}
+}
+
+bool BatchRunner::isBatchInvocation(int argc, char *argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--batch") == 0 || std::strcmp(argv[i], "--replay") == 0) return true;
+    }
+    return false;
+}
+
+int BatchRunner::main(int argc, char *argv[]) {
+    // 关卡文件随可执行文件一起部署
+    std::string executable = argv[0];
+    size_t slash = executable.find_last_of("/\\");
+    if (slash != std::string::npos) Level::addSearchPath(executable.substr(0, slash) + "/levels");
+
+    // 输入回放模式
+    std::string replayPath;
+    std::string latencyPath;
+    int maxP95Ms = 0;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (std::strcmp(argv[i], "--replay") == 0) replayPath = argv[i + 1];
+        else if (std::strcmp(argv[i], "--latency-out") == 0) latencyPath = argv[i + 1];
+        else if (std::strcmp(argv[i], "--max-p95-ms") == 0) maxP95Ms = std::atoi(argv[i + 1]);
+    }
+    if (!replayPath.empty()) {
+        return replayLatency(replayPath, latencyPath, maxP95Ms);
+    }
+
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (std::strcmp(arg, "--batch") == 0) {
+            continue;
+        } else if (value && std::strcmp(arg, "--matches") == 0) {
+            options.matches = std::atoi(value); i++;
+        } else if (value && std::strcmp(arg, "--seed") == 0) {
+            options.seed = std::strtoull(value, nullptr, 10); i++;
+        } else if (value && std::strcmp(arg, "--threads") == 0) {
+            options.threads = std::atoi(value); i++;
+        } else if (value && std::strcmp(arg, "--max-seconds") == 0) {
+            options.maxDurationMs = std::atoi(value) * 1000; i++;
+        } else if (value && std::strcmp(arg, "--difficulty") == 0) {
+            options.botDifficulty = std::atoi(value); i++;
+        } else if (value && std::strcmp(arg, "--level") == 0) {
+            options.level = value; i++;
+        } else if (value && std::strcmp(arg, "--players") == 0) {
+            options.players = std::atoi(value); i++;
+        } else if (value && std::strcmp(arg, "--teams") == 0) {
+            options.teams = std::atoi(value); i++;
+        } else if (value && std::strcmp(arg, "--sim-hz") == 0) {
+            options.tickHz = std::atoi(value); i++;
+        } else if (value && std::strcmp(arg, "--out") == 0) {
+            options.outputPath = value; i++;
+        } else if (value && std::strcmp(arg, "--policy") == 0) {
+            if (std::strcmp(value, "bot") == 0) options.policy = BOT;
+            else if (std::strcmp(value, "mixed") == 0) options.policy = MIXED;
+            else options.policy = SCRIPTED;
+            i++;
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+    if (options.matches <= 0 || options.botDifficulty < 0 || options.botDifficulty > 2 ||
+        options.players < 2 || options.players > SimWorld::MAX_PLAYERS ||
+        options.teams < 0 || options.teams == 1 || options.teams > options.players ||
+        (options.tickHz != 0 && (options.tickHz < SimWorld::MIN_TICK_HZ || options.tickHz > SimWorld::MAX_TICK_HZ)) ||
+        !Level::byName(options.level)) {
+        printUsage();
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<MatchResult> results = run(options);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!writeCsv(options.outputPath, results)) {
+        std::fprintf(stderr, "无法写入 %s\n", options.outputPath.c_str());
+        return 1;
+    }
+
+    int sides = options.teams > 0 ? options.teams : options.players;
+    std::vector<int> wins(sides + 1, 0);
+    for (const MatchResult& r : results) wins[r.winner]++;
+    std::printf("%d 局完成，用时 %.2f 秒，%.1f 局/秒\n", options.matches, seconds,
+                seconds > 0 ? options.matches / seconds : 0.0);
+    for (int s = 1; s <= sides; s++) {
+        std::printf("%s%d胜 %d，", options.teams > 0 ? "队伍" : "玩家", s, wins[s]);
+    }
+    std::printf("平局 %d，结果已写入 %s\n", wins[0], options.outputPath.c_str());
+    return 0;
+}
+
+BatchRunner::MatchResult BatchRunner::playMatch(int index, uint64_t seed, const Options& options) {
+    SimWorld world;
+    world.reset(seed, Level::byName(options.level), options.players, options.teams);
+    world.setTickRate(options.tickHz);
+    world.startSpawning();
+
+    SimRng policyRng(seed ^ 0xA5A5A5A5A5A5A5A5ull);
+    SimRng profileRng(seed ^ 0x5BD1E9955BD1E995ull);   // 单独的随机流，不影响电脑的决策
+    ScriptedProfile profiles[SimWorld::MAX_PLAYERS];
+    for (int p = 0; p < world.playerCount; p++) profiles[p] = randomProfile(profileRng);
+    InputState inputs[SimWorld::MAX_PLAYERS];
+    TickInput tickInput[SimWorld::MAX_PLAYERS];
+
+    for (int tick = 0; !world.isOver() && world.elapsedMs < options.maxDurationMs; tick++) {
+        for (int p = 0; p < world.playerCount; p++) {
+            if (!world.isAlive(p)) continue;
+            bool usesBot = options.policy == BOT || (options.policy == MIXED && p > 0);
+            if (usesBot) {
+                // 电脑每个宏动作决策一次；跳跃和攻击先松开再按下以重新触发
+                if (tick % BotSearch::ACTION_TICKS == 0) {
+                    BotSearch::Action action = BotSearch::searchSerial(
+                        world, p, static_cast<BotSearch::Difficulty>(options.botDifficulty), policyRng.next());
+                    inputs[p].release(INPUT_JUMP | INPUT_ATTACK);
+                    inputs[p].setHeld(BotSearch::actionInput(action));
+                }
+            } else {
+                inputs[p].setHeld(scriptedInput(world, p, profiles[p], policyRng));
+            }
+            tickInput[p] = inputs[p].sample();
+        }
+        world.step(tickInput);
+    }
+
+    MatchResult result;
+    result.index = index;
+    result.seed = seed;
+    result.winner = std::max(world.winner(), 0);
+    result.durationMs = world.elapsedMs;
+    result.players = world.playerCount;
+    for (int p = 0; p < world.playerCount; p++) {
+        result.stats[p] = world.stats[p];
+    }
+    return result;
+}
+
+std::vector<BatchRunner::MatchResult> BatchRunner::run(const Options& options) {
+    std::vector<MatchResult> results(options.matches);
+    int threadCount = options.threads > 0 ? options.threads
+                                          : static_cast<int>(std::thread::hardware_concurrency());
+    if (threadCount <= 0) threadCount = 1;
+
+    // 每个线程从共享计数器领取对局，各局之间没有共享状态
+    std::atomic<int> next{0};
+    auto worker = [&]() {
+        for (int i = next++; i < options.matches; i = next++) {
+            results[i] = playMatch(i, matchSeed(options.seed, i), options);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 1; t < threadCount; t++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    return results;
+}
+
+bool BatchRunner::writeCsv(const std::string& path, const std::vector<MatchResult>& results) {
+    std::ofstream out(path);
+    if (!out) return false;
+
+    // 列数按玩家数，同一批次的对局玩家数相同
+    int players = results.empty() ? 2 : results.front().players;
+    out << "match,seed,winner,duration_ms";
+    for (int p = 1; p <= players; p++) {
+        for (const char* weapon : WEAPON_NAMES) out << ",p" << p << "_damage_" << weapon;
+        out << ",p" << p << "_items";
+        for (const char* item : ITEM_NAMES) out << ",p" << p << "_pickup_" << item;
+        out << ",p" << p << "_armor_consumed";
+    }
+    out << "\n";
+
+    for (const MatchResult& r : results) {
+        out << r.index << ',' << r.seed << ',' << r.winner << ',' << r.durationMs;
+        for (int p = 0; p < r.players; p++) {
+            const SimStats& s = r.stats[p];
+            int totalItems = 0;
+            for (int count : s.itemsPickedUp) totalItems += count;
+            for (int damage : s.damageByWeapon) out << ',' << damage;
+            out << ',' << totalItems;
+            for (int count : s.itemsPickedUp) out << ',' << count;
+            out << ',' << s.armorDurabilityConsumed;
+        }
+        out << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+BatchRunner::ScriptedProfile BatchRunner::randomProfile(SimRng& rng) {
+    ScriptedProfile profile;
+    profile.engageAfterMs = rng.bounded(10000, 50000);
+    profile.hesitatePercent = rng.bounded(5, 20);
+    profile.itemFirst = rng.bounded(0, 2) == 0;
+    profile.jumpOdds = rng.bounded(15, 60);
+    return profile;
+}
+
+uint8_t BatchRunner::scriptedInput(const SimWorld& world, int player, const ScriptedProfile& profile, SimRng& rng) {
+    const SimCharacter& me = world.characters[player];
+    int target = world.nearestEnemy(player);
+    if (target < 0) return 0;
+    const SimCharacter& enemy = world.characters[target];
+    uint8_t input = 0;
+
+    // 随机犹豫
+    if (rng.bounded(0, 100) < profile.hesitatePercent) return 0;
+
+    int myCenter = me.x + me.width / 2;
+    int myFeet = me.y + me.height;
+
+    // 站在落地道具上时下蹲拾取（上一帧未下蹲才会触发）
+    int pickupY = myFeet - 10;
+    for (const SimItem& item : world.items) {
+        if (item.onGround && myCenter >= item.x && myCenter <= item.x + SimItem::SIZE &&
+            pickupY >= item.y && pickupY <= item.y + SimItem::SIZE) {
+            return (world.previousInput[player] & INPUT_CROUCH) ? 0 : INPUT_CROUCH;
+        }
+    }
+
+    // 目标：最近的落地道具；没有道具时，未到交战时间就退到对手的另一侧，否则走向对手
+    bool engaging = world.elapsedMs >= profile.engageAfterMs;
+    int targetX = enemy.x + enemy.width / 2;
+    int targetFeet = enemy.y + enemy.height;
+    const SimItem* wanted = nullptr;
+    if (profile.itemFirst || me.weapon == SimCharacter::FIST) {
+        int bestDistance = 0;
+        for (const SimItem& item : world.items) {
+            if (!item.onGround) continue;
+            int distance = std::abs(item.x + SimItem::SIZE / 2 - myCenter) + std::abs(item.y + SimItem::SIZE - myFeet);
+            if (!wanted || distance < bestDistance) {
+                wanted = &item;
+                bestDistance = distance;
+            }
+        }
+    }
+    if (wanted) {
+        targetX = wanted->x + SimItem::SIZE / 2;
+        targetFeet = wanted->y + SimItem::SIZE;
+    } else if (!engaging) {
+        targetX = targetX < world.level->width / 2 ? world.level->width * 3 / 4 : world.level->width / 4;
+        targetFeet = myFeet;
+    }
+
+    // 去捡道具时要停在道具正上方，比走向对手时停得更准
+    int dx = targetX - myCenter;
+    int tolerance = wanted ? SimItem::SIZE / 4 : me.width / 2;
+    if (dx < -tolerance) input |= INPUT_LEFT;
+    else if (dx > tolerance) input |= INPUT_RIGHT;
+
+    // 与对手同高且距离较近时攻击（隔帧按键以产生按下沿）；交战前不远程攻击
+    int enemyDx = std::abs(enemy.x - me.x);
+    bool ranged = me.weapon == SimCharacter::BALL || me.weapon == SimCharacter::RIFLE || me.weapon == SimCharacter::SNIPER;
+    if (std::abs(enemy.y - me.y) < me.height && ((ranged && engaging) || enemyDx < me.width * 2)) {
+        if (!(world.previousInput[player] & INPUT_ATTACK)) input |= INPUT_ATTACK;
+    }
+
+    // 偶尔跳跃去往高处的目标
+    if (targetFeet < myFeet - 10 && rng.bounded(0, profile.jumpOdds) == 0) {
+        input |= INPUT_JUMP;
+    }
+    return input;
+}
+
+int BatchRunner::replayLatency(const std::string& replayPath, const std::string& latencyPath, int maxP95Ms) {
+    LatencyProbe::ReplayHeader header;
+    std::vector<LatencyProbe::Event> events;
+    if (!LatencyProbe::readReplay(replayPath, header, events)) {
+        std::fprintf(stderr, "无法读取回放 %s\n", replayPath.c_str());
+        return 1;
+    }
+
+    // 与 GameScreen 构造时的初始状态一致
+    std::shared_ptr<const Level> level = Level::byName(header.level);
+    if (!level) {
+        std::fprintf(stderr, "未知关卡 %s\n", header.level.c_str());
+        return 1;
+    }
+    SimWorld world;
+    world.reset(header.seed, level, header.players, header.teams);
+    world.tickUs = header.tickUs;   // 按录制时的帧长回放（不经换算，避免取整误差）
+    for (int p = 0; p < world.playerCount; p++) {
+        world.setCharacterSize(p, header.width[p], header.height[p]);
+    }
+
+    // 按记录的帧号注入输入；事件时刻按记录的等待时间倒推，
+    // 采样之后的处理时间（模拟一帧）实测，无界面时以处理完成代替绘制
+    LatencyProbe probe;
+    InputState inputs[SimWorld::MAX_PLAYERS];
+    TickInput tickInput[SimWorld::MAX_PLAYERS];
+    int64_t lastTick = events.empty() ? 0 : events.back().tick;
+    size_t next = 0;
+    for (int64_t tick = 0; tick <= lastTick && !world.isOver(); tick++) {
+        if (tick == header.spawnTick) world.startSpawning();
+
+        int64_t tickUs = LatencyProbe::nowUs();
+        for (; next < events.size() && events[next].tick <= tick; next++) {
+            const LatencyProbe::Event& e = events[next];
+            if (e.pressed) inputs[e.player - 1].press(e.bit);
+            else inputs[e.player - 1].release(e.bit);
+            probe.markInput(e.player, e.bit, e.pressed, e.measured, tickUs + e.inputUs);
+        }
+        for (int p = 0; p < world.playerCount; p++) {
+            tickInput[p] = inputs[p].sample();
+        }
+        probe.markTick(tick, tickUs);
+        world.step(tickInput);
+        probe.markPresent(LatencyProbe::nowUs());
+    }
+
+    if (!latencyPath.empty() && !probe.writeCsv(latencyPath)) {
+        std::fprintf(stderr, "无法写入 %s\n", latencyPath.c_str());
+        return 1;
+    }
+
+    std::printf("输入 %lld 个，延迟 平均 %.2f ms，P50 %.0f ms，P95 %.0f ms，P99 %.0f ms，最大 %.2f ms\n",
+                static_cast<long long>(probe.count()), probe.meanUs() / 1000.0,
+                probe.percentileUs(0.50) / 1000.0, probe.percentileUs(0.95) / 1000.0,
+                probe.percentileUs(0.99) / 1000.0, probe.maxUs() / 1000.0);
+    if (maxP95Ms > 0 && probe.percentileUs(0.95) > static_cast<int64_t>(maxP95Ms) * 1000) {
+        std::fprintf(stderr, "P95 延迟超过 %d ms\n", maxP95Ms);
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,71 @@
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Simulation.h"
+#include "LatencyProbe.h"
+
+// 无界面批量对战：每局独立运行在工作线程上，结果写入CSV，用于数值平衡测试
+class BatchRunner {
+public:
+    // 各玩家的控制方式
+    enum Policy { SCRIPTED, BOT, MIXED }; // MIXED: 玩家1脚本，其余电脑
+
+    struct Options {
+        int matches = 1000;
+        uint64_t seed = 1;
+        int threads = 0;                    // 0表示使用全部核心
+        int maxDurationMs = 300000;         // 超时判平局
+        Policy policy = SCRIPTED;
+        int botDifficulty = 1;              // BotSearch::Difficulty
+        int players = 2;                    // 2 ~ SimWorld::MAX_PLAYERS
+        int teams = 0;                      // 0=各自为战
+        int tickHz = 0;                     // 模拟频率，0为默认
+        std::string level = "classic";      // 内置关卡名
+        std::string outputPath = "batch_results.csv";
+    };
+
+    struct MatchResult {
+        int index = 0;
+        uint64_t seed = 0;
+        int winner = 0;                     // 获胜的玩家（组队时为队伍）编号，0=平局（超时或同时倒下）
+        int64_t durationMs = 0;
+        int players = 2;
+        SimStats stats[SimWorld::MAX_PLAYERS];
+    };
+
+    // 命令行中是否包含 --batch 或 --replay（无界面运行）
+    static bool isBatchInvocation(int argc, char *argv[]);
+
+    // 命令行入口，返回进程退出码
+    static int main(int argc, char *argv[]);
+
+    // 运行一局对战
+    static MatchResult playMatch(int index, uint64_t seed, const Options& options);
+
+    // 多线程运行全部对战，结果按对局编号排列
+    static std::vector<MatchResult> run(const Options& options);
+
+    // 写出CSV
+    static bool writeCsv(const std::string& path, const std::vector<MatchResult>& results);
+
+    // 回放游戏中导出的输入记录并测量输入延迟；maxP95Ms>0 时超出则返回非零（用于自动检测延迟回退）
+    static int replayLatency(const std::string& replayPath, const std::string& latencyPath, int maxP95Ms);
+
+    // 脚本玩家的性格，每局每人随机抽取，避免双方完全对称
+    struct ScriptedProfile {
+        int engageAfterMs = 0;          // 此前与对手保持距离，只在被贴身时还手
+        int hesitatePercent = 10;       // 每帧什么也不做的概率
+        bool itemFirst = false;         // 有道具时总是先去捡（否则只在赤手空拳时去捡）
+        int jumpOdds = 30;              // 目标在高处时每帧以 1/jumpOdds 的概率起跳
+    };
+
+    static ScriptedProfile randomProfile(SimRng& rng);
+
+    // 简单脚本策略：按性格捡道具、躲避或走向最近的对手攻击，站在道具上时下蹲拾取
+    static uint8_t scriptedInput(const SimWorld& world, int player, const ScriptedProfile& profile, SimRng& rng);
+};
+
+#endif // BATCH_RUNNER_H
@@ -0,0 +1,92 @@
+#include "BotController.h"
+#include "GameScreen.h"
+#include <QRandomGenerator>
+
+BotController::BotController(GameScreen *screen, QThreadPool *pool, int player, BotSearch::Difficulty difficulty,
+                             QObject *parent)
+    : QObject(parent), screen(screen), playerIndex(player - 1), searchDifficulty(difficulty), pool(pool) {
+    // 决策定时器：每个宏动作的持续时间决策一次
+    decisionTimer = new QTimer(this);
+    connect(decisionTimer, &QTimer::timeout, this, &BotController::think);
+    start();
+}
+
+// 线程池由其他电脑共用，不能 waitForDone；等本对象的工作线程全部结束，
+// 之后投递给本对象的结果随对象一起删除
+BotController::~BotController() {
+    if (!pendingJob) return;
+    pendingJob->cancelled = true;
+    std::unique_lock<std::mutex> lock(finishMutex);
+    workersDone.wait(lock, [this]() { return pendingJob->remainingWorkers == 0; });
+}
+
+void BotController::start() {
+    decisionTimer->start(qMax(1, BotSearch::ACTION_TICKS * screen->tickUs() / 1000));
+}
+
+void BotController::stop() {
+    decisionTimer->stop();
+    if (pendingJob) pendingJob->cancelled = true;
+    applyAction(BotSearch::IDLE);
+}
+
+// 发起一次决策：复制世界状态，把推演分发到线程池，界面线程立即返回
+void BotController::think() {
+    if (pendingJob) return; // 上一次搜索尚未完成，跳过本次决策
+
+    BotSearch::Budget budget = BotSearch::budgetFor(searchDifficulty);
+    auto job = std::make_shared<BotSearch::Job>();
+    screen->captureWorld(job->root);
+    job->player = playerIndex;
+    job->depthTicks = budget.depthTicks;
+    job->startTime = std::chrono::steady_clock::now();
+    job->deadline = job->startTime + std::chrono::microseconds(budget.timeBudgetUs);
+
+    int workers = qMax(1, pool->maxThreadCount() / qMax(1, screen->botCount()));
+    job->remainingWorkers = workers;
+    pendingJob = job;
+
+    quint64 baseSeed = QRandomGenerator::global()->generate64();
+    for (int i = 0; i < workers; i++) {
+        pool->start([this, job, seed = baseSeed + i]() {
+            BotSearch::runWorker(*job, seed);
+            std::lock_guard<std::mutex> lock(finishMutex);
+            if (--job->remainingWorkers == 0) {
+                QMetaObject::invokeMethod(this, [this, job]() { finishSearch(job); }, Qt::QueuedConnection);
+                workersDone.notify_all();
+            }
+        });
+    }
+}
+
+// 所有工作线程结束后在界面线程执行
+void BotController::finishSearch(std::shared_ptr<BotSearch::Job> job) {
+    if (pendingJob == job) pendingJob.reset();
+    if (job->cancelled || !decisionTimer->isActive()) return;
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - job->startTime).count();
+    if (seconds > 0) {
+        lastNodesPerSecond = static_cast<double>(job->nodes) / seconds;
+    }
+    applyAction(BotSearch::bestAction(*job));
+}
+
+// 把宏动作转换为按键按下/松开；跳跃和攻击每次决策重新按下以触发一次
+void BotController::applyAction(BotSearch::Action action) {
+    static const InputBit bits[] = { INPUT_CROUCH, INPUT_LEFT, INPUT_RIGHT, INPUT_JUMP, INPUT_ATTACK };
+    const uint8_t edgeBits = INPUT_JUMP | INPUT_ATTACK;
+    uint8_t desired = BotSearch::actionInput(action);
+
+    for (InputBit bit : bits) {
+        if ((heldInput & bit) && (!(desired & bit) || (bit & edgeBits))) {
+            screen->applyPlayerInput(player(), bit, false);
+            heldInput &= ~bit;
+        }
+    }
+    for (InputBit bit : bits) {
+        if ((desired & bit) && !(heldInput & bit)) {
+            screen->applyPlayerInput(player(), bit, true);
+            heldInput |= bit;
+        }
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef BOT_CONTROLLER_H
+#define BOT_CONTROLLER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QThreadPool>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include "BotSearch.h"
+
+class GameScreen;
+
+// 电脑对手控制器：定时复制世界状态，在线程池上做前瞻搜索，
+// 搜索结果通过与键盘相同的输入接口（GameScreen::applyPlayerInput）驱动角色。
+// 同一对战的所有电脑共用 GameScreen 的线程池，每次决策按电脑数量分摊线程
+class BotController : public QObject {
+    Q_OBJECT
+public:
+    BotController(GameScreen *screen, QThreadPool *pool, int player, BotSearch::Difficulty difficulty,
+                  QObject *parent = nullptr);
+    ~BotController();
+
+    // 控制的玩家编号（从1开始）
+    int player() const { return playerIndex + 1; }
+
+    // 难度
+    BotSearch::Difficulty difficulty() const { return searchDifficulty; }
+    void setDifficulty(BotSearch::Difficulty difficulty) { searchDifficulty = difficulty; }
+
+    // 最近一次决策的搜索速度（节点/秒，一个节点为一帧模拟）
+    double nodesPerSecond() const { return lastNodesPerSecond; }
+
+    // 松开所有按键并停止决策；start 重新开始定时决策（构造后即开始）
+    void stop();
+    void start();
+
+private:
+    void think();
+    void finishSearch(std::shared_ptr<BotSearch::Job> job);
+    void applyAction(BotSearch::Action action);
+
+    GameScreen *screen;
+    int playerIndex;
+    BotSearch::Difficulty searchDifficulty;
+    QTimer *decisionTimer;
+    QThreadPool *pool;                        // 共用的线程池，析构时只等待本对象的推演结束
+    std::shared_ptr<BotSearch::Job> pendingJob;
+    std::mutex finishMutex;                   // 最后一个工作线程在锁内投递结果
+    std::condition_variable workersDone;
+    uint8_t heldInput = 0;                    // 当前按住的按键
+    double lastNodesPerSecond = 0.0;
+};
+
+#endif // BOT_CONTROLLER_H
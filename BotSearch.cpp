@@ -0,0 +1,158 @@
+#include "BotSearch.h"
+#include <cstdlib>
+
+BotSearch::Job::Job() {
+    for (int i = 0; i < ACTION_COUNT; i++) {
+        scoreSum[i] = 0;
+        visits[i] = 0;
+    }
+}
+
+BotSearch::Budget BotSearch::budgetFor(Difficulty difficulty) {
+    switch (difficulty) {
+    case EASY: return {1000, 30, 1200};
+    case NORMAL: return {4000, 60, 4800};
+    case HARD: return {12000, 90, 14400};
+    }
+    return {4000, 60, 4800};
+}
+
+uint8_t BotSearch::actionInput(Action action) {
+    switch (action) {
+    case LEFT: return INPUT_LEFT;
+    case RIGHT: return INPUT_RIGHT;
+    case JUMP: return INPUT_JUMP;
+    case JUMP_LEFT: return INPUT_JUMP | INPUT_LEFT;
+    case JUMP_RIGHT: return INPUT_JUMP | INPUT_RIGHT;
+    case CROUCH: return INPUT_CROUCH;
+    case ATTACK: return INPUT_ATTACK;
+    default: return 0;
+    }
+}
+
+// 武器价值（近战弱于远程）
+static int weaponValue(const SimCharacter& c) {
+    switch (c.weapon) {
+    case SimCharacter::KNIFE: return 8;
+    case SimCharacter::BALL: return 6 + c.ballUses;
+    case SimCharacter::RIFLE: return 10 + c.rifleAmmo / 4;
+    case SimCharacter::SNIPER: return 12 + c.sniperAmmo;
+    default: return 0;
+    }
+}
+
+int BotSearch::evaluate(const SimWorld& world, int player) {
+    const SimCharacter& me = world.characters[player];
+
+    int w = world.winner();
+    if (w == me.team + 1) return 100000;
+    if (w != 0) return -100000;
+
+    // 多人对战时只针对最近的对手
+    int target = world.nearestEnemy(player);
+    if (target < 0) return 0;
+    const SimCharacter& enemy = world.characters[target];
+
+    int score = (me.health - enemy.health) * 100;
+    score += (weaponValue(me) - weaponValue(enemy)) * 20;
+    if (me.lightArmor) score += 150;
+    if (me.bulletproofVest) score += me.vestDurability * 2;
+    if (me.adrenalineActive) score += 100;
+    if (!me.visible) score += 50;
+
+    // 近战武器时靠近对手，远程武器时保持距离但不离开同一高度
+    int dx = std::abs((me.x + me.width / 2) - (enemy.x + enemy.width / 2));
+    int dy = std::abs(me.y - enemy.y);
+    if (me.weapon == SimCharacter::FIST || me.weapon == SimCharacter::KNIFE) {
+        score -= dx / 4 + dy / 4;
+    } else {
+        score -= dy / 2;
+    }
+
+    // 接近落地的道具
+    for (const SimItem& item : world.items) {
+        if (!item.onGround) continue;
+        int ix = std::abs(item.x + SimItem::SIZE / 2 - (me.x + me.width / 2));
+        int iy = std::abs(item.y + SimItem::SIZE - (me.y + me.height));
+        score -= (ix + iy) / 20;
+    }
+    return score;
+}
+
+int BotSearch::rollout(const SimWorld& root, int player, Action first, int depthTicks,
+                       SimRng& rng, uint64_t& nodes, TickArena& arena) {
+    SimWorld world(root, &arena);
+    Action actions[SimWorld::MAX_PLAYERS];
+    actions[player] = first;
+    for (int p = 0; p < world.playerCount; p++) {
+        if (p != player) actions[p] = static_cast<Action>(rng.bounded(0, ACTION_COUNT));
+    }
+    TickInput input[SimWorld::MAX_PLAYERS];
+
+    for (int tick = 0; tick < depthTicks && !world.isOver(); tick++) {
+        bool newAction = tick % ACTION_TICKS == 0;
+        if (tick > 0 && newAction) {
+            actions[player] = static_cast<Action>(rng.bounded(0, ACTION_COUNT));
+            for (int p = 0; p < world.playerCount; p++) {
+                if (p != player) actions[p] = static_cast<Action>(rng.bounded(0, ACTION_COUNT));
+            }
+        }
+        // 宏动作开始时按下，之后保持；其他玩家随机行动
+        for (int p = 0; p < world.playerCount; p++) {
+            input[p].held = actionInput(actions[p]);
+            input[p].pressed = newAction ? input[p].held : 0;
+        }
+        world.step(input);
+        nodes++;
+    }
+    return evaluate(world, player);
+}
+
+void BotSearch::runWorker(Job& job, uint64_t seed) {
+    if (job.cancelled) return; // 在共用线程池里排队时已被取消
+    SimRng rng(seed);
+    uint64_t nodes = 0;
+    TickArena arena(16 * 1024); // 每次推演的世界副本用完即弃
+    do {
+        Action action = static_cast<Action>(job.nextAction.fetch_add(1) % ACTION_COUNT);
+        int score = rollout(job.root, job.player, action, job.depthTicks, rng, nodes, arena);
+        arena.reset();
+        job.scoreSum[action] += score;
+        job.visits[action]++;
+    } while (!job.cancelled &&
+             (job.nodeBudget == 0 || nodes < job.nodeBudget) &&
+             std::chrono::steady_clock::now() < job.deadline);
+    job.nodes += nodes;
+}
+
+BotSearch::Action BotSearch::bestAction(const Job& job) {
+    Action best = IDLE;
+    double bestScore = 0;
+    bool found = false;
+    for (int i = 0; i < ACTION_COUNT; i++) {
+        int n = job.visits[i];
+        if (n == 0) continue;
+        double avg = static_cast<double>(job.scoreSum[i]) / n;
+        if (!found || avg > bestScore) {
+            best = static_cast<Action>(i);
+            bestScore = avg;
+            found = true;
+        }
+    }
+    return best;
+}
+
+BotSearch::Action BotSearch::searchSerial(const SimWorld& world, int player, Difficulty difficulty,
+                                          uint64_t seed, uint64_t* nodes) {
+    Budget budget = budgetFor(difficulty);
+    Job job;
+    job.root = world;
+    job.player = player;
+    job.depthTicks = budget.depthTicks;
+    job.nodeBudget = budget.nodeBudget;
+    job.startTime = std::chrono::steady_clock::now();
+    job.deadline = std::chrono::steady_clock::time_point::max();
+    runWorker(job, seed);
+    if (nodes) *nodes = job.nodes;
+    return bestAction(job);
+}
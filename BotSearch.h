@@ -0,0 +1,65 @@
+#ifndef BOT_SEARCH_H
+#define BOT_SEARCH_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "Simulation.h"
+#include "TickArena.h"
+
+// 电脑对手的前瞻搜索：对每个候选动作在世界副本上做随机推演，取平均得分最高者
+class BotSearch {
+public:
+    // 候选宏动作，每个动作保持 ACTION_TICKS 帧
+    enum Action { IDLE, LEFT, RIGHT, JUMP, JUMP_LEFT, JUMP_RIGHT, CROUCH, ATTACK, ACTION_COUNT };
+    static constexpr int ACTION_TICKS = 6;
+
+    // 难度：搜索预算越大，推演越深，电脑越强
+    enum Difficulty { EASY, NORMAL, HARD };
+    struct Budget {
+        int timeBudgetUs;   // 每次决策的时间预算（微秒）
+        int depthTicks;     // 每次推演的帧数
+        int nodeBudget;     // 单线程搜索的节点上限（批量对战用，保证结果可复现）
+    };
+    static Budget budgetFor(Difficulty difficulty);
+
+    // 一次决策的共享搜索任务，可由多个工作线程同时推进
+    struct Job {
+        SimWorld root;
+        int player = 1;
+        int depthTicks = 60;
+        uint64_t nodeBudget = 0;            // 每个工作线程的节点上限，0表示只受时间限制
+        std::chrono::steady_clock::time_point startTime;
+        std::chrono::steady_clock::time_point deadline;
+        std::atomic<int64_t> scoreSum[ACTION_COUNT];
+        std::atomic<int> visits[ACTION_COUNT];
+        std::atomic<int> nextAction{0};
+        std::atomic<uint64_t> nodes{0};
+        std::atomic<int> remainingWorkers{0};
+        std::atomic<bool> cancelled{false};
+
+        Job();
+    };
+
+    // 工作线程入口：在截止时间前不断推演，结果累加到 job
+    static void runWorker(Job& job, uint64_t seed);
+
+    // 平均得分最高的动作
+    static Action bestAction(const Job& job);
+
+    // 单线程搜索（无界面批量对战使用），只受节点上限约束，相同种子结果相同
+    static Action searchSerial(const SimWorld& world, int player, Difficulty difficulty,
+                               uint64_t seed, uint64_t* nodes = nullptr);
+
+    // 动作对应的按键组合
+    static uint8_t actionInput(Action action);
+
+    // 局面评估（站在 player 一方）
+    static int evaluate(const SimWorld& world, int player);
+
+private:
+    static int rollout(const SimWorld& root, int player, Action first, int depthTicks,
+                       SimRng& rng, uint64_t& nodes, TickArena& arena);
+};
+
+#endif // BOT_SEARCH_H
@@ -1,8 +1,7 @@
 #include "Bullet.h"
 
-Bullet::Bullet(int startX, int startY, bool directionRight, Character* shooter, int charWidth, int charHeight, QWidget *parent)
-    : QWidget(parent), directionRight(directionRight), shooter(shooter),
-    bulletSpeed(12) {
+Bullet::Bullet(bool directionRight, int charWidth, int charHeight, QWidget *parent)
+    : QWidget(parent), directionRight(directionRight) {
     setAttribute(Qt::WA_TransparentForMouseEvents);
     setAttribute(Qt::WA_NoSystemBackground);
 
@@ -11,24 +10,19 @@ Bullet::Bullet(int startX, int startY, bool directionRight, Character* shooter,
 
     // 加载子弹图片
     if (directionRight) {
-        bulletPixmap = QPixmap(":/new/prefix1/res/bulletb2.png");
+        pixmapPath = ":/new/prefix1/res/bulletb2.png";
     } else {
-        bulletPixmap = QPixmap(":/new/prefix1/res/bulletb1.png");
+        pixmapPath = ":/new/prefix1/res/bulletb1.png";
     }
+    bulletPixmap = QPixmap(pixmapPath);
 
     if (!bulletPixmap.isNull()) {
         bulletPixmap = bulletPixmap.scaled(size(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
     }
+}
 
-    // 初始位置
-    x = startX;
-    y = startY;
-    move(x, y);
-
-    // 定时器更新位置
-    updateTimer = new QTimer(this);
-    connect(updateTimer, &QTimer::timeout, this, &Bullet::updatePosition);
-    updateTimer->start(16); // 约60FPS
+void Bullet::reportMemory(MemoryStats &stats) const {
+    stats.addPixmap(pixmapPath, bulletPixmap);
 }
 
 void Bullet::paintEvent(QPaintEvent *event) {
@@ -41,21 +35,3 @@ void Bullet::paintEvent(QPaintEvent *event) {
         painter.drawEllipse(rect());
     }
 }
-
-void Bullet::updatePosition() {
-    // 更新位置
-    if (directionRight) {
-        x += bulletSpeed;
-    } else {
-        x -= bulletSpeed;
-    }
-
-    move(x, y);
-
-    // 检查是否碰到屏幕边缘
-    int screenWidth = parentWidget() ? parentWidget()->width() : 1200;
-    if (x < -50 || x > screenWidth + 50) {
-        active = false;
-        hide();
-    }
-}
@@ -3,33 +3,17 @@
 
 #include <QWidget>
 #include <QPixmap>
-#include <QTimer>
 #include <QPainter>
-#include "Character.h"
+#include "MemoryStats.h"
 
-// 子弹类
-class Bullet : public QWidget {
+// 子弹显示类（飞行由 SimWorld 计算）
+class Bullet : public QWidget, public MemoryReporter {
     Q_OBJECT
 public:
-    Bullet(int startX, int startY, bool directionRight, Character* shooter, int charWidth, int charHeight, QWidget *parent = nullptr);
+    Bullet(bool directionRight, int charWidth, int charHeight, QWidget *parent = nullptr);
     ~Bullet() {}
 
-    // 获取碰撞矩形
-    QRect getRect() const {
-        return QRect(x, y, width(), height());
-    }
-
-    // 获取射击者
-    Character* getShooter() const { return shooter; }
-
-    // 是否活动状态
-    bool isActive() const { return active; }
-
-    void setActive(bool isActive) {
-        active = isActive;
-    }
-
-    // 设置子弹图片 - 新增
+    // 设置子弹图片
     void setBulletPixmap(const QPixmap& pixmap) {
         bulletPixmap = pixmap;
         if (!bulletPixmap.isNull()) {
@@ -38,21 +22,15 @@ public:
         update();
     }
 
+    void reportMemory(MemoryStats &stats) const override;
+
 protected:
     void paintEvent(QPaintEvent *event) override;
 
-private slots:
-    void updatePosition();
-
 private:
-    static constexpr int GRAVITY = 1;
     bool directionRight;
-    Character* shooter;
-    int x, y;
-    int bulletSpeed;
     QPixmap bulletPixmap;
-    QTimer *updateTimer;
-    bool active = true;  // 活动状态标志
+    QString pixmapPath;
 };
 
 #endif // BULLET_H
@@ -4,8 +4,9 @@
 #include <QPainter>
 #include <QDebug>
 
-Character::Character(const QString& spritePath, bool isPlayer1, QWidget *parent)
-    : QWidget(parent), player1(isPlayer1) {
+Character::Character(const QString& spritePath, Animator *animator,
+                     const AnimationLibrary *animations, QWidget *parent)
+    : QWidget(parent), spritePath(spritePath), animator(animator) {
     // 加载角色精灵图
     spriteSheet = QPixmap(spritePath);
     if (spriteSheet.isNull()) {
@@ -16,81 +17,21 @@ Character::Character(const QString& spritePath, bool isPlayer1, QWidget *parent)
         setFixedSize(frameWidth, frameHeight);
     }
 
-    // 初始化属性
-    health = 100;
-    currentWeapon = FIST;
-
-    // 动画定时器
-    animationTimer = new QTimer(this);
-    connect(animationTimer, &QTimer::timeout, this, [this]() { updateFrame(); });
-
-    // 水平移动定时器
-    moveTimer = new QTimer(this);
-    connect(moveTimer, &QTimer::timeout, this, [this]() {
-        if (moveDirection != 0 && !isCrouching) {
-            int newX = characterX + moveDirection * moveSpeed;
-            bool collision = false;
-            if (platforms) {
-                for (const Platform& p : *platforms) {
-                    bool onPlatform = (characterY + frameHeight >= p.y) &&
-                                      (characterY + frameHeight <= p.y + 5) &&
-                                      (newX + frameWidth > p.x) &&
-                                      (newX < p.x + p.width);
-                    bool sideCollision = p.intersects(newX, characterY, frameWidth, frameHeight);
-                    if (!onPlatform && sideCollision) {
-                        collision = true;
-                        break;
-                    }
-                }
-            }
-            if (!collision) {
-                characterX = newX;
-                move(characterX, characterY);
-                updateArmorPosition();
-            }
-        }
-    });
-
-    // 重力定时器
-    gravityTimer = new QTimer(this);
-    connect(gravityTimer, &QTimer::timeout, this, [this]() { applyGravity(); });
-    gravityTimer->start(16);
+    // 身体动画
+    bodyAnimation = animator->create();
+    idleClips[0] = animations->find("idle_left");
+    idleClips[1] = animations->find("idle_right");
+    walkClips[0] = animations->find("walk_left");
+    walkClips[1] = animations->find("walk_right");
+    crouchClip = animations->find("crouch");
+    animator->play(bodyAnimation, idleClips[0]);
 
     // 创建攻击特效
-    attackEffect = new AttackEffect(parentWidget());
+    attackEffect = new AttackEffect(animator, animations, parentWidget());
     attackEffect->hide();
-    knifeEffect = new KnifeAttackEffect(parentWidget());
+    knifeEffect = new KnifeAttackEffect(animator, animations, parentWidget());
     knifeEffect->hide();
 
-    // 无敌帧定时器
-    invincibleTimer = new QTimer(this);
-    invincibleTimer->setSingleShot(true);
-    connect(invincibleTimer, &QTimer::timeout, this, [this]() {
-        isInvincible = false;
-        armorDamageEffect = false;
-        update();
-    });
-
-    // 地形效果检测定时器
-    terrainEffectTimer = new QTimer(this);
-    connect(terrainEffectTimer, &QTimer::timeout, this, [this]() { checkTerrainEffects(); });
-    terrainEffectTimer->start(100);
-
-    // 肾上腺素效果定时器
-    adrenalineTimer = new QTimer(this);
-    connect(adrenalineTimer, &QTimer::timeout, this, [this]() {
-        if (isAdrenalineActive) {
-            heal(1);
-            adrenalineRemainingTime -= 250;
-            if (adrenalineRemainingTime <= 0) {
-                isAdrenalineActive = false;
-                moveSpeed = baseMoveSpeed;
-                checkTerrainEffects();
-                update();
-            }
-        }
-    });
-
     // 加载武器图片
     knifeRightPixmap = QPixmap(":/new/prefix1/res/knife.png");
     knifeLeftPixmap = QPixmap(":/new/prefix1/res/knife2.png");
@@ -133,12 +74,6 @@ Character::Character(const QString& spritePath, bool isPlayer1, QWidget *parent)
         sniperLeftPixmap = sniperLeftPixmap.scaled(width, height, Qt::KeepAspectRatio, Qt::SmoothTransformation);
     }
 
-    // 射击间隔定时器
-    rifleShootTimer = new QTimer(this);
-    rifleShootTimer->setSingleShot(true);
-    sniperShootTimer = new QTimer(this);
-    sniperShootTimer->setSingleShot(true);
-
     // 初始化护甲标签
     armorLabel = new QLabel(parentWidget());
     armorLabel->setAttribute(Qt::WA_TransparentForMouseEvents);
@@ -151,324 +86,131 @@ Character::Character(const QString& spritePath, bool isPlayer1, QWidget *parent)
     vestLabel->hide();
 }
 
-// 位置设置函数
-void Character::setPos(int x, int y) {
-    characterX = x;
-    characterY = y;
+// 根据模拟状态更新显示
+void Character::syncFromState(const SimCharacter& state, int drawX, int drawY) {
+    characterX = drawX;
+    characterY = drawY;
     move(characterX, characterY);
-    updateArmorPosition();
-}
 
-void Character::setPlatforms(std::vector<Platform>* p) {
-    platforms = p;
-}
-
-// 移动方向设置
-void Character::setMoveDirection(int direction) {
-    if (isCrouching) return;
-
-    moveDirection = direction;
-    if (direction != 0) {
-        currentRow = (direction < 0) ? 1 : 2;
-        if (!animationTimer->isActive()) {
-            animationTimer->start(animationSpeed);
-            currentFrame = 0;
-        }
-        if (!moveTimer->isActive()) {
-            moveTimer->start(30);
-        }
-    } else {
-        moveTimer->stop();
-        currentFrame = 0;
-        update();
-    }
-}
+    // 下蹲、朝向与行走动画
+    isCrouching = state.crouching;
+    facingRight = state.facingRight;
+    updateBodyAnimation(state);
 
-// 下蹲状态设置
-void Character::setCrouching(bool crouch) {
-    if (isCrouching == crouch) return;
-
-    isCrouching = crouch;
-    if (isCrouching) {
-        lastDirectionRow = currentRow;
-        currentRow = 0;
-        animationTimer->stop();
-        update();
-        if (isOnGrass) {
-            setVisible(false);
-        }
-    } else {
-        currentRow = lastDirectionRow;
-        if (moveDirection != 0) {
-            animationTimer->start(animationSpeed);
+    // 新的近战攻击：播放对应特效
+    if (state.meleeRemainingMs > lastMeleeRemainingMs) {
+        if (state.weapon == SimCharacter::KNIFE) {
+            knifeEffect->startAttack(state.facingRight, characterX, characterY, frameWidth, frameHeight);
+            knifeEffect->raise();
         } else {
-            currentFrame = 0;
-            update();
+            attackEffect->startAttack(state.facingRight, characterX, characterY, frameWidth, frameHeight);
+            attackEffect->raise();
         }
-        setVisible(true);
-    }
-}
-
-// 攻击方法
-void Character::attack() {
-    switch (currentWeapon) {
-    case FIST: punch(); break;
-    case KNIFE: knifeAttack(); break;
-    case BALL: throwBall(); break;
-    case RIFLE: rifleAttack(); break;
-    case SNIPER: sniperAttack(); break;
-    }
-}
-
-void Character::knifeAttack() {
-    bool attackRight = isFacingRight();
-    knifeEffect->startAttack(attackRight, characterX, characterY, frameWidth, frameHeight);
-    knifeEffect->raise();
-}
-
-void Character::punch() {
-    bool attackRight = isFacingRight();
-    attackEffect->startAttack(attackRight, characterX, characterY, frameWidth, frameHeight);
-    attackEffect->raise();
-}
-
-void Character::throwBall() {
-    ballUses--;
-    bool throwRight = isFacingRight();
-    emit ballThrown(characterX, characterY, throwRight, this);
-    if (ballUses <= 0) {
-        equipFist();
-    }
-}
-
-void Character::rifleAttack() {
-    if (rifleShootTimer->isActive() || rifleAmmo <= 0) return;
-
-    rifleAmmo--;
-    bool shootRight = isFacingRight();
-    int startX = characterX;
-    int startY = characterY;
-
-    if (shootRight) {
-        startX += frameWidth * 0.4;
-    } else {
-        startX -= frameWidth * 0.1;
-    }
-
-    startY += frameHeight * 0.5;
-    emit bulletShot(startX, startY, shootRight, this);
-    rifleShootTimer->start(500);
-
-    if (rifleAmmo <= 0) {
-        equipFist();
-    }
-}
-
-void Character::sniperAttack() {
-    if (sniperShootTimer->isActive() || sniperAmmo <= 0) return;
-
-    sniperAmmo--;
-    bool shootRight = isFacingRight();
-    int startX = characterX;
-    int startY = characterY;
-
-    if (shootRight) {
-        startX += frameWidth * 0.4;
-    } else {
-        startX -= frameWidth * 0.1;
     }
+    lastMeleeRemainingMs = state.meleeRemainingMs;
+    attackEffect->syncAnimation();
+    knifeEffect->syncAnimation();
+
+    // 状态效果
+    currentWeapon = static_cast<Weapon>(state.weapon);
+    isInvincible = state.invincibleMs > 0;
+    damageColor = state.armorAbsorbedHit ? Qt::yellow : Qt::red;
+    isAdrenalineActive = state.adrenalineActive;
+    bool shown = state.visible && state.health > 0; // 多人对战中倒下的角色不再显示
+    setVisible(shown);
+
+    // 护甲：标签是父控件上的独立控件，随角色一起隐藏
+    if (state.lightArmor != lightArmorEquipped) setLightArmorEquipped(state.lightArmor);
+    if (state.bulletproofVest != bulletproofVestEquipped) setBulletproofVestEquipped(state.bulletproofVest);
+    armorLabel->setVisible(shown && lightArmorEquipped);
+    vestLabel->setVisible(shown && bulletproofVestEquipped);
+    updateArmorPosition();
 
-    startY += frameHeight * 0.5;
-    emit sniperBulletShot(startX, startY, shootRight, this);
-    sniperShootTimer->start(2000);
-
-    if (sniperAmmo <= 0) {
-        equipFist();
-    }
-}
-
-// 装备武器方法
-void Character::equipKnife() { currentWeapon = KNIFE; }
-void Character::equipFist() { currentWeapon = FIST; }
-
-void Character::equipBall() {
-    currentWeapon = BALL;
-    ballUses = 3;
-}
-
-void Character::equipRifle() {
-    currentWeapon = RIFLE;
-    rifleAmmo = 20;
-}
-
-void Character::equipSniper() {
-    currentWeapon = SNIPER;
-    sniperAmmo = 5;
+    health = state.health;
+    update();
 }
 
-void Character::equipLightArmor() {
-    if (bulletproofVestEquipped) {
-        bulletproofVestEquipped = false;
-        vestLabel->hide();
-    }
-    lightArmorEquipped = true;
+// 装备锁子甲时载入标签图片，标签是否显示由 syncFromState 决定
+void Character::setLightArmorEquipped(bool equipped) {
+    lightArmorEquipped = equipped;
+    if (!equipped) return;
 
-    QPixmap armorPix(":/new/prefix1/res/dun.png");
-    if (!armorPix.isNull()) {
+    armorPixmap = QPixmap(":/new/prefix1/res/dun.png");
+    if (!armorPixmap.isNull()) {
         int size = qMax(frameWidth, frameHeight) *0.5;
         armorLabel->setFixedSize(size*2, size);
-        armorPix = armorPix.scaled(size, size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-        armorLabel->setPixmap(armorPix);
+        armorPixmap = armorPixmap.scaled(size, size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        armorLabel->setPixmap(armorPixmap);
     }
-    armorLabel->show();
     armorLabel->raise();
     updateArmorPosition();
 }
 
-void Character::equipBulletproofVest() {
-    if (lightArmorEquipped) {
-        lightArmorEquipped = false;
-        armorLabel->hide();
-    }
-    bulletproofVestEquipped = true;
-    vestDurability = 100;
+// 装备防弹衣时载入标签图片
+void Character::setBulletproofVestEquipped(bool equipped) {
+    bulletproofVestEquipped = equipped;
+    if (!equipped) return;
 
-    QPixmap vestPix(":/new/prefix1/res/dun2.png");
-    if (!vestPix.isNull()) {
+    vestPixmap = QPixmap(":/new/prefix1/res/dun2.png");
+    if (!vestPixmap.isNull()) {
         int size = qMax(frameWidth, frameHeight) *0.5;
         vestLabel->setFixedSize(size, size);
-        vestPix = vestPix.scaled(size, size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-        vestLabel->setPixmap(vestPix);
+        vestPixmap = vestPixmap.scaled(size, size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        vestLabel->setPixmap(vestPixmap);
     }
-    vestLabel->show();
     vestLabel->raise();
     updateArmorPosition();
 }
 
-// 方向判断
-bool Character::isFacingRight() const {
-    if (isCrouching) {
-        return lastDirectionRow == 2;
-    }
-    return currentRow == 2;
-}
-
-// 跳跃方法
-void Character::jump() {
-    if (isCrouching) return;
-
-    if (canJump) {
-        verticalVelocity = JUMP_VELOCITY;
-        canJump = false;
-        if (isInAir) {
-            doubleJumpUsed = true;
-        }
-        isInAir = true;
-    }
-}
-
-// 受伤害处理
-void Character::takeDamage(int damage, Weapon damageSource) {
-    if (isInvincible) return;
-
-    // 护甲伤害调整
-    if (lightArmorEquipped) {
-        if (damageSource == FIST) damage = 0;
-        else if (damageSource == KNIFE) damage = 2;
-    } else if (bulletproofVestEquipped) {
-        if (damageSource == RIFLE) {
-            damage = 2;
-            vestDurability -= 10;
-        } else if (damageSource == SNIPER) {
-            damage = 10;
-            vestDurability -= 40;
-        }
-        if (vestDurability <= 0) {
-            bulletproofVestEquipped = false;
-            vestLabel->hide();
-        }
+// 选择身体动画：停下时把当前的行走循环播完再回到站立
+void Character::updateBodyAnimation(const SimCharacter& state) {
+    const AnimationPlayer& body = animator->player(bodyAnimation);
+    int direction = state.facingRight ? 1 : 0;
+    bool walking = body.clip == walkClips[0] || body.clip == walkClips[1];
+
+    const AnimationClip* target;
+    if (state.crouching) {
+        target = crouchClip;
+    } else if (state.moveDirection != 0 || (walking && body.frame != 0)) {
+        target = walkClips[direction];
+    } else {
+        target = idleClips[direction];
     }
+    if (target == body.clip) return;
 
-    // 受击效果
-    if (lightArmorEquipped && (damageSource == FIST || damageSource == KNIFE)) {
-        damageColor = Qt::yellow;
-    } else if (bulletproofVestEquipped && (damageSource == RIFLE || damageSource == SNIPER)) {
-        damageColor = Qt::yellow;
-    } else if (damage > 0) {
-        damageColor = Qt::red;
+    if (walking && (target == walkClips[0] || target == walkClips[1])) {
+        animator->switchTo(bodyAnimation, target); // 行走中转身，保持步伐
+    } else {
+        animator->play(bodyAnimation, target);
     }
-
-    health -= damage;
-    if (health < 0) health = 0;
-    emit healthChanged(health);
-
-    // 无敌状态
-    isInvincible = true;
-    invincibleTimer->start(300);
 }
 
-// 治疗处理
-void Character::heal(int amount) {
-    health += amount;
-    if (health > 100) health = 100;
-    emit healthChanged(health);
+void Character::setTag(const QString& text, const QColor& color) {
+    tag = text;
+    tagColor = color;
+    update();
 }
 
-void Character::fullHeal() {
-    health = 100;
-    emit healthChanged(health);
+// 方向判断
+bool Character::isFacingRight() const {
+    return facingRight;
 }
 
-// 地形效果检测
-void Character::checkTerrainEffects() {
-    if (!platforms) return;
-
-    isOnGrass = false;
-    isOnIce = false;
-
-    for (const Platform& p : *platforms) {
-        bool onPlatform = (characterY + frameHeight >= p.y) &&
-                          (characterY + frameHeight <= p.y + 5) &&
-                          (characterX + frameWidth > p.x) &&
-                          (characterX < p.x + p.width);
-
-        if (onPlatform) {
-            if (p.type == 1) isOnGrass = true;
-            else if (p.type == 2) isOnIce = true;
-        }
-    }
-
-    // 草地隐身效果
-    if (isOnGrass && isCrouching) {
-        setVisible(false);
-    } else if (isOnGrass && !isCrouching) {
-        setVisible(true);
-    }
-
-    // 冰面加速效果
-    if (isOnIce) {
-        moveSpeed = isAdrenalineActive ? baseMoveSpeed * 2.0 : baseMoveSpeed * 1.5;
-    } else {
-        moveSpeed = isAdrenalineActive ? baseMoveSpeed * 1.5 : baseMoveSpeed;
-    }
+Character::Weapon Character::getCurrentWeapon() const {
+    return currentWeapon;
 }
 
-// 肾上腺素效果
-void Character::activateAdrenaline() {
-    if (isAdrenalineActive) {
-        adrenalineRemainingTime = ADRENALINE_DURATION;
-        return;
-    }
-
-    isAdrenalineActive = true;
-    adrenalineRemainingTime = ADRENALINE_DURATION;
-    moveSpeed = baseMoveSpeed * 1.5;
-
-    if (!adrenalineTimer->isActive()) {
-        adrenalineTimer->start(250);
-    }
-    checkTerrainEffects();
-    update();
+void Character::reportMemory(MemoryStats &stats) const {
+    stats.addPixmap(spritePath, spriteSheet);
+    stats.addPixmap(":/new/prefix1/res/knife.png", knifeRightPixmap);
+    stats.addPixmap(":/new/prefix1/res/knife2.png", knifeLeftPixmap);
+    stats.addPixmap(":/new/prefix1/res/ball.png", ballPixmap);
+    stats.addPixmap(":/new/prefix1/res/AKM.png", rifleRightPixmap);
+    stats.addPixmap(":/new/prefix1/res/AKM2.png", rifleLeftPixmap);
+    stats.addPixmap(":/new/prefix1/res/juji.png", sniperRightPixmap);
+    stats.addPixmap(":/new/prefix1/res/juji2.png", sniperLeftPixmap);
+    stats.addPixmap(":/new/prefix1/res/dun.png", armorPixmap);
+    stats.addPixmap(":/new/prefix1/res/dun2.png", vestPixmap);
 }
 
 // 绘制角色
@@ -478,13 +220,14 @@ void Character::paintEvent(QPaintEvent *event) {
 
     QPainter painter(this);
     painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    const AnimationFrame* frame = animator->player(bodyAnimation).currentFrame();
+    int column = frame ? frame->column : 0;
+    int row = frame ? frame->row : (facingRight ? 2 : 1);
     painter.drawPixmap(0, 0, spriteSheet,
-                       currentFrame * frameWidth,
-                       currentRow * frameHeight,
+                       column * frameWidth,
+                       row * frameHeight,
                        frameWidth, frameHeight);
 
-    bool facingRight = isFacingRight();
-
     // 绘制装备的武器
     if (currentWeapon == KNIFE) {
         if (facingRight && !knifeRightPixmap.isNull()) {
@@ -524,57 +267,14 @@ void Character::paintEvent(QPaintEvent *event) {
     if (isAdrenalineActive) {
         painter.fillRect(rect(), QColor(0, 100, 255, 100));
     }
-}
 
-// 动画帧更新
-void Character::updateFrame() {
-    currentFrame = (currentFrame + 1) % 4;
-    update();
-    if (moveDirection == 0 && currentFrame == 0) {
-        animationTimer->stop();
+    // 头顶标签
+    if (!tag.isEmpty()) {
+        painter.setPen(tagColor);
+        painter.drawText(rect(), Qt::AlignTop | Qt::AlignHCenter, tag);
     }
 }
 
-// 重力应用
-void Character::applyGravity() {
-    verticalVelocity += GRAVITY;
-    int newY = characterY + verticalVelocity;
-    bool onPlatform = false;
-
-    if (platforms) {
-        for (const Platform& p : *platforms) {
-            if (newY + frameHeight >= p.top() &&
-                characterY + frameHeight <= p.top() + 5 &&
-                characterX + frameWidth > p.x &&
-                characterX < p.x + p.width &&
-                verticalVelocity >= 0) {
-                characterY = p.top() - frameHeight;
-                verticalVelocity = 0;
-                isInAir = false;
-                canJump = true;
-                doubleJumpUsed = false;
-                onPlatform = true;
-                break;
-            }
-        }
-    }
-
-    if (!onPlatform) {
-        characterY = newY;
-        if (characterY > 800) {
-            characterY = 100;
-            characterX = 600;
-            verticalVelocity = 0;
-        }
-        if (verticalVelocity != 0) {
-            isInAir = true;
-        }
-    }
-
-    move(characterX, characterY);
-    updateArmorPosition();
-}
-
 // 护甲位置更新
 void Character::updateArmorPosition() {
     if (armorLabel && armorLabel->isVisible()) {
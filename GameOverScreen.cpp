@@ -39,11 +39,13 @@ GameOverScreen::GameOverScreen(QWidget *parent) : QWidget(parent) {
     connect(returnButton, &QPushButton::clicked, this, &GameOverScreen::returnToStart);
 }
 
-void GameOverScreen::setWinner(int winner) {
-    if (winner == 1) {
-        winnerLabel->setText("Winner: Role 1");
-    } else if (winner == 2) {
-        winnerLabel->setText("Winner: Role 2");
+void GameOverScreen::setWinner(int winner, bool team) {
+    if (winner <= 0) {
+        winnerLabel->setText("Draw");
+    } else if (team) {
+        winnerLabel->setText(QString("Winner: Team %1").arg(winner));
+    } else {
+        winnerLabel->setText(QString("Winner: Role %1").arg(winner));
     }
 }
 
@@ -13,8 +13,8 @@ class GameOverScreen : public QWidget {
 public:
     GameOverScreen(QWidget *parent = nullptr);
 
-    // 设置胜利者
-    void setWinner(int winner);
+    // 设置胜利者：玩家编号或队伍编号，SimWorld::DRAW 为平局
+    void setWinner(int winner, bool team = false);
 
     // 重写resizeEvent确保背景正确调整大小
     void resizeEvent(QResizeEvent *event) override;
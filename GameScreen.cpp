@@ -1,12 +1,66 @@
 #include "GameScreen.h"
+#include "BotController.h"
+#include "MatchSnapshot.h"
 #include <QPainter>
 #include <QLayout>
 #include <QHBoxLayout>
 #include <QVBoxLayout>
 #include <QRandomGenerator>
+#include <QDebug>
+#include <QFile>
+#include <QSaveFile>
+#include <QThread>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <vector>
+
+namespace {
+// 各玩家（组队时各队伍）的标识颜色
+const QColor PLAYER_COLORS[SimWorld::MAX_PLAYERS] = {
+    QColor(230, 60, 60), QColor(70, 120, 240), QColor(60, 190, 90), QColor(240, 160, 40),
+    QColor(190, 80, 220), QColor(40, 200, 210), QColor(230, 220, 60), QColor(220, 220, 220)
+};
+
+// 默认键位：玩家1 WASD+F，玩家2 方向键+L，玩家3 小键盘 4/6/8/5 + 0
+struct DefaultBinding {
+    int key;
+    int player;
+    InputBit bit;
+};
+const DefaultBinding DEFAULT_BINDINGS[] = {
+    { Qt::Key_A, 1, INPUT_LEFT }, { Qt::Key_D, 1, INPUT_RIGHT }, { Qt::Key_W, 1, INPUT_JUMP },
+    { Qt::Key_S, 1, INPUT_CROUCH }, { Qt::Key_F, 1, INPUT_ATTACK },
+    { Qt::Key_Left, 2, INPUT_LEFT }, { Qt::Key_Right, 2, INPUT_RIGHT }, { Qt::Key_Up, 2, INPUT_JUMP },
+    { Qt::Key_Down, 2, INPUT_CROUCH }, { Qt::Key_L, 2, INPUT_ATTACK },
+    { Qt::Key_4, 3, INPUT_LEFT }, { Qt::Key_6, 3, INPUT_RIGHT }, { Qt::Key_8, 3, INPUT_JUMP },
+    { Qt::Key_5, 3, INPUT_CROUCH }, { Qt::Key_0, 3, INPUT_ATTACK }
+};
+
+// 存档先写到临时文件，同步到磁盘后再替换旧存档（QSaveFile），
+// 写到一半时崩溃只会留下旧存档，不会出现新旧数据混在一起的文件
+bool writeSaveFile(const QString &path, const std::vector<char> &data) {
+    QSaveFile file(path);
+    qint64 size = static_cast<qint64>(data.size());
+    if (!file.open(QIODevice::WriteOnly) || file.write(data.data(), size) != size || !file.commit()) {
+        qWarning() << "无法写入存档:" << path;
+        return false;
+    }
+    return true;
+}
+}
+
+GameScreen::GameScreen(const MatchSetup &matchSetup, QWidget *parent) : QWidget(parent), setup(matchSetup) {
+    setup.players = qBound(2, setup.players, SimWorld::MAX_PLAYERS);
+    setup.teams = setup.teams >= 2 ? qMin(setup.teams, setup.players) : 0;
+    setup.humans = qBound(0, setup.humans, qMin(setup.players, KEYBOARD_PLAYERS));
 
-GameScreen::GameScreen(QWidget *parent) : QWidget(parent) {
     setFocusPolicy(Qt::StrongFocus);
+    setAttribute(Qt::WA_OpaquePaintEvent); // 每帧由静态图层整体覆盖，不需要先擦除
+
+    // 电脑对手共用的推演线程：留出界面线程和模拟线程
+    botPool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 2));
+    savePool.setMaxThreadCount(1);      // 存档按提交顺序依次写盘
 
     // 主布局
     QVBoxLayout *mainLayout = new QVBoxLayout(this);
@@ -14,47 +68,33 @@ GameScreen::GameScreen(QWidget *parent) : QWidget(parent) {
     mainLayout->setSpacing(0);
 
     // 顶部血条容器
-    QWidget *topBar = new QWidget(this);
+    topBar = new QWidget(this);
     topBar->setFixedHeight(50);
     topBar->setStyleSheet("background-color: rgba(0, 0, 0, 100);");
 
     QHBoxLayout *topLayout = new QHBoxLayout(topBar);
     topLayout->setContentsMargins(20, 10, 20, 10);
 
-    // 玩家1血条
-    healthContainer1 = new QWidget(topBar);
-    healthContainer1->setFixedSize(204, 24);
-    healthContainer1->setStyleSheet("background-color: black; border: 2px solid #555;");
-
-    healthBar1 = new QLabel(healthContainer1);
-    healthBar1->setGeometry(2, 2, 200, 20);
-    healthBar1->setStyleSheet("background-color: red;");
-
-    healthText1 = new QLabel(healthContainer1);
-    healthText1->setGeometry(0, 0, 200, 20);
-    healthText1->setAlignment(Qt::AlignCenter);
-    healthText1->setStyleSheet("color: white; font-weight: bold;");
-    healthText1->setText("100");
-
-    // 玩家2血条
-    healthContainer2 = new QWidget(topBar);
-    healthContainer2->setFixedSize(204, 24);
-    healthContainer2->setStyleSheet("background-color: black; border: 2px solid #555;");
-
-    healthBar2 = new QLabel(healthContainer2);
-    healthBar2->setGeometry(2, 2, 200, 20);
-    healthBar2->setStyleSheet("background-color: red;");
-
-    healthText2 = new QLabel(healthContainer2);
-    healthText2->setGeometry(0, 0, 200, 20);
-    healthText2->setAlignment(Qt::AlignCenter);
-    healthText2->setStyleSheet("color: white; font-weight: bold;");
-    healthText2->setText("100");
-
-    // 添加到顶部布局
-    topLayout->addWidget(healthContainer1);
-    topLayout->addStretch();
-    topLayout->addWidget(healthContainer2);
+    // 每名玩家一个血条，均匀分布；人数多时缩短（见 layoutHud）
+    for (int i = 0; i < setup.players; i++) {
+        PlayerHud hud;
+        hud.container = new QWidget(topBar);
+        hud.container->setStyleSheet(setup.players > 2
+            ? QString("background-color: black; border: 2px solid %1;").arg(playerColor(i).name())
+            : QString("background-color: black; border: 2px solid #555;"));
+
+        hud.bar = new QLabel(hud.container);
+        hud.bar->setStyleSheet("background-color: red;");
+
+        hud.text = new QLabel(hud.container);
+        hud.text->setAlignment(Qt::AlignCenter);
+        hud.text->setStyleSheet("color: white; font-weight: bold;");
+
+        if (i > 0) topLayout->addStretch();
+        topLayout->addWidget(hud.container);
+        huds.append(hud);
+    }
+    layoutHud();
 
     // 游戏区域
     gameArea = new QWidget(this);
@@ -64,283 +104,1114 @@ GameScreen::GameScreen(QWidget *parent) : QWidget(parent) {
     mainLayout->addWidget(topBar);
     mainLayout->addWidget(gameArea);
 
-    // 创建平台
-    createPlatforms();
+    // 粒子特效层，位于角色和道具上方
+    particles = new ParticleSystem(gameArea);
+    particles->raise();
 
-    // 创建角色
-    character1 = new Character(":/new/prefix1/res/role1.png", true, gameArea);
-    character1->setPlatforms(&platforms);
-    character1->setPos(200, 450 - character1->getHeight());
-    character1->raise();
+    // 装饰物图片（各区块共享）
+    decorationPixmaps[Decoration::GRASS] = QPixmap(":/new/prefix1/res/grass.png").scaled(210, 60, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    decorationPixmaps[Decoration::SNOW] = QPixmap(":/new/prefix1/res/xuedui.png").scaled(210, 60, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
 
-    character2 = new Character(":/new/prefix1/res/role2.png", false, gameArea);
-    character2->setPlatforms(&platforms);
-    character2->setPos(900, 450 - character2->getHeight());
-    character2->raise();
+    // 创建角色显示，碰撞尺寸取精灵帧大小
+    // 动画数据：角色和攻击特效共用，由模拟帧统一推进
+    QFile animationFile(":/new/prefix1/res/animations.txt");
+    std::string animationError;
+    if (!animationFile.open(QIODevice::ReadOnly) ||
+        !animations.parse(animationFile.readAll().toStdString(), &animationError)) {
+        qDebug() << "动画数据加载失败:" << QString::fromStdString(animationError);
+    }
+
+    // 两套角色精灵交替使用，多人时在头顶标出玩家编号
+    for (int i = 0; i < setup.players; i++) {
+        Character* character = new Character(i % 2 == 0 ? ":/new/prefix1/res/role1.png" : ":/new/prefix1/res/role2.png",
+                                             &animator, &animations, gameArea);
+        character->raise();
+        if (setup.players > 2) character->setTag(QString("P%1").arg(i + 1), playerColor(i));
+        characters.append(character);
+    }
+
+    // 按键绑定：只为键盘控制的玩家启用默认键位
+    for (const DefaultBinding& binding : DEFAULT_BINDINGS) {
+        if (binding.player <= setup.humans) setKeyBinding(binding.key, binding.player, binding.bit);
+    }
+    bots.fill(nullptr, setup.players);
+
+    // 载入标准竞技场
+    matchSeed = QRandomGenerator::global()->generate64();
+    loadLevel(Level::classic());
 
     // 连接信号
-    connect(character1, &Character::healthChanged, this, [this](int health) { updateHealthBar(1, health); });
-    connect(character2, &Character::healthChanged, this, [this](int health) { updateHealthBar(2, health); });
-
-    connect(character1, &Character::ballThrown, this, [this](int x, int y, bool right, Character* thrower) {
-        BallProjectile* ball = new BallProjectile(x, y, right, thrower, gameArea);
-        ball->show();
-        ball->raise();
-        ballProjectiles.append(ball);
-    });
+    for (int i = 0; i < characters.size(); i++) {
+        Character* character = characters[i];
+        AttackEffect* fist = character->getAttackEffect();
+        KnifeAttackEffect* knife = character->getKnifeEffect();
+        connect(fist, &AttackEffect::animationEvent, this, [this, fist](const QString& name) { onEffectEvent(fist, name); });
+        connect(knife, &KnifeAttackEffect::animationEvent, this, [this, knife](const QString& name) { onEffectEvent(knife, name); });
+    }
+
+    // 显示帧定时器：定时器只负责唤醒，模拟推进多少帧由 frameClock 决定，
+    // 定时器抖动不会改变游戏速度
+    frameTimer = new QTimer(this);
+    frameTimer->setTimerType(Qt::PreciseTimer);
+    connect(frameTimer, &QTimer::timeout, this, &GameScreen::frameTick);
+    frameClock.start();
+    setDisplayRate(DEFAULT_DISPLAY_RATE);
 
-    // 其他信号连接...
+    autosaveTimer = new QTimer(this);
+    connect(autosaveTimer, &QTimer::timeout, this, [this]() { saveMatch(); });
+}
 
-    // 平台调试定时器
-    platformDebugTimer = new QTimer(this);
-    connect(platformDebugTimer, &QTimer::timeout, this, [this]() { update(); });
-    platformDebugTimer->start(100);
+GameScreen::~GameScreen() {
+    // 对战进行中（包括暂停时）关闭窗口：保留最后的进度
+    if (matchStarted) saveMatch(QUICKSAVE_FILE, true);
+    savePool.waitForDone();
+    // 压力测试的回调引用本对象，先让模拟线程退出
+    simulation.stop();
+    // 电脑对手的推演在 botPool 上，先于线程池删除
+    for (BotController*& bot : bots) {
+        delete bot;
+        bot = nullptr;
+    }
+}
 
-    // 攻击检测定时器
-    attackCheckTimer = new QTimer(this);
-    connect(attackCheckTimer, &QTimer::timeout, this, &GameScreen::checkAttack);
-    attackCheckTimer->start(50);
+void GameScreen::setDisplayRate(int hz) {
+    if (hz <= 0) return;
+    frameIntervalMs = qMax(1, 1000 / hz);
+    if (!isSuspended()) frameTimer->start(frameIntervalMs);
+}
 
-    // 游戏结束检测定时器
-    gameOverTimer = new QTimer(this);
-    connect(gameOverTimer, &QTimer::timeout, this, &GameScreen::checkGameOver);
-    gameOverTimer->start(100);
+// 暂停期间收不到按键松开事件，暂停前先松开所有按键（命令在继续后的第一帧之前执行）
+void GameScreen::setSuspended(SuspendReason reason, bool suspended) {
+    bool wasSuspended = isSuspended();
+    if (suspended) suspendReasons |= reason;
+    else suspendReasons &= ~reason;
+    update();
+    if (isSuspended() == wasSuspended) return;
 
-    // 地形标签
-    grassLabel = new QLabel(gameArea);
-    grassLabel->setPixmap(QPixmap(":/new/prefix1/res/grass.png").scaled(210, 60, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
-    grassLabel->setGeometry(210, 250, 210, 60);
-    grassLabel->lower();
+    if (isSuspended()) {
+        frameTimer->stop();
+        autosaveTimer->stop();
+        for (BotController* bot : bots) {
+            if (bot) bot->stop();
+        }
+        for (int player = 1; player <= setup.players; player++) {
+            SimulationThread::Command command;
+            command.type = SimulationThread::Command::CLEAR_INPUT;
+            command.player = static_cast<uint8_t>(player);
+            simulation.post(command);
+        }
+        simulation.stop();
+    } else if (!gameOverEmitted) {
+        simulation.start();
+        lastFrameNs = frameClock.nsecsElapsed();
+        frameTimer->start(frameIntervalMs);
+        for (BotController* bot : bots) {
+            if (bot) bot->start();
+        }
+        if (matchStarted) autosaveTimer->start(AUTOSAVE_INTERVAL_MS);
+    }
+}
 
-    snowLabel = new QLabel(gameArea);
-    snowLabel->setPixmap(QPixmap(":/new/prefix1/res/xuedui.png").scaled(210, 60, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
-    snowLabel->setGeometry(775, 250, 210, 60);
-    snowLabel->lower();
+// 切换到其他界面时隐藏；窗口最小化时收到系统发出的隐藏事件
+void GameScreen::showEvent(QShowEvent *event) {
+    QWidget::showEvent(event);
+    setSuspended(SUSPEND_HIDDEN, false);
+}
 
-    // 道具生成定时器初始化
-    bandageSpawnTimer = new QTimer(this);
-    connect(bandageSpawnTimer, &QTimer::timeout, this, &GameScreen::spawnBandage);
-    // 其他道具定时器...
+void GameScreen::hideEvent(QHideEvent *event) {
+    QWidget::hideEvent(event);
+    setSuspended(SUSPEND_HIDDEN, true);
+}
 
-    // 道具更新定时器
-    itemUpdateTimer = new QTimer(this);
-    connect(itemUpdateTimer, &QTimer::timeout, this, &GameScreen::updateItems);
-    itemUpdateTimer->start(16);
+// 压力测试在后台运行也要持续加压，不因失去焦点暂停
+void GameScreen::changeEvent(QEvent *event) {
+    QWidget::changeEvent(event);
+    if (event->type() == QEvent::ActivationChange && !stressRamp) {
+        setSuspended(SUSPEND_INACTIVE, !isActiveWindow());
+    }
 }
 
 void GameScreen::setBackground(const QPixmap &pixmap) {
-    if (!pixmap.isNull()) {
-        background = new QLabel(this);
-        background->setPixmap(pixmap);
-        background->setGeometry(0, 0, width(), height());
-        background->lower();
-        if (grassLabel) grassLabel->raise();
-        if (snowLabel) snowLabel->raise();
+    backgroundSource = pixmap;
+    backgroundLayer = QImage();
+    staticLayerLeft = -1;
+}
+
+// 键盘控制以外的玩家由电脑接管。
+// 读档时不投递开始生成的命令：模拟线程可能在读档之后才执行它，会覆盖存档里的生成计时
+void GameScreen::startMatch(bool resuming) {
+    for (int i = setup.humans; i < setup.players; i++) {
+        if (!bots[i]) bots[i] = new BotController(this, &botPool, i + 1, BotSearch::EASY, this);
+        if (isSuspended()) bots[i]->stop();
     }
+    if (!resuming || !resumeMatch()) startSpawningItems();
+    matchStarted = true;
+    if (!isSuspended()) autosaveTimer->start(AUTOSAVE_INTERVAL_MS);
 }
 
+// 由模拟线程在下一帧开始生成，并记下开始的帧（回放用）
 void GameScreen::startSpawningItems() {
-    bandageSpawnTimer->start(20000);
-    medkitSpawnTimer->start(30000);
-    adrenalineSpawnTimer->start(60000);
-    knifeSpawnTimer->start(45000);
-    ballSpawnTimer->start(60000);
-    rifleSpawnTimer->start(70000);
-    sniperSpawnTimer->start(90000);
-    lightArmorSpawnTimer->start(55000);
-    bulletproofVestSpawnTimer->start(65000);
+    SimulationThread::Command command;
+    command.type = SimulationThread::Command::START_SPAWNING;
+    simulation.post(command);
 }
 
-void GameScreen::createPlatforms() {
-    platforms.push_back(Platform(100, 450, 1000, 100, 0));
-    platforms.push_back(Platform(210, 280, 210, 1, 1));
-    platforms.push_back(Platform(775, 280, 210, 1, 2));
-    platforms.push_back(Platform(500, 100, 200, 1, 0));
+void GameScreen::setTelemetry(Telemetry *log) {
+    telemetry = log;
+    simulation.setTelemetry(log);
 }
 
-void GameScreen::spawnBandage() {
-    int x = QRandomGenerator::global()->bounded(100, 1000);
-    Item* bandage = new Item(Item::BANDAGE, gameArea);
-    bandage->move(x, 0);
-    bandage->show();
-    bandage->raise();
-    items.append(bandage);
+// 停止模拟线程后直接重置它的世界，重新启动时从新世界开始发布
+void GameScreen::loadLevel(std::shared_ptr<const Level> level) {
+    simulation.stop();
+    simulation.reset(matchSeed, level, setup.players, setup.teams);
+    simulation.world().setTickRate(setup.tickHz);
+    simTickNs = simulation.world().tickUs * 1000LL;
+    for (int i = 0; i < characters.size(); i++) {
+        if (characters[i]->getWidth() > 0 && characters[i]->getHeight() > 0) {
+            simulation.world().setCharacterSize(i, characters[i]->getWidth(), characters[i]->getHeight());
+        }
+    }
+    world = simulation.world();
+    previousWorld = world;
+    resetViews();
+    if (!isSuspended()) simulation.start();
 }
 
-// 其他道具生成函数...
+void GameScreen::resetViews() {
+    invalidateStaticLayer();
+    particles->clear();
+    for (Item* view : itemViews) view->deleteLater();
+    itemViews.clear();
+    for (QWidget* view : projectileViews) view->deleteLater();
+    projectileViews.clear();
 
-void GameScreen::updateItems() {
-    for (Item* item : items) {
-        item->updatePosition(platforms);
+    // 旧世界的事件不再显示，血条按新世界刷新
+    simulation.discardEvents();
+    reportedDroppedEvents = simulation.droppedEvents();
+    for (int i = 0; i < huds.size() && i < world.playerCount; i++) updateHealthBar(i + 1, world.characters[i].health);
+
+    updateCamera(1.0, 1.0);
+    updateChunks();
+    syncViews(1.0);
+}
+
+// 界面线程只把正在显示的世界副本写进内存（不需要暂停模拟线程），
+// 写盘和同步到磁盘在 savePool 上进行，不占用绘制帧的时间。上一份还没写完时跳过这次
+bool GameScreen::saveMatch(const QString &path, bool wait) {
+    if (gameOverEmitted) return false;
+    if (wait) savePool.waitForDone();
+    else if (saveInFlight.exchange(true)) return false;
+
+    QElapsedTimer timer;
+    timer.start();
+    auto data = std::make_shared<std::vector<char>>(MatchSnapshot::size(world));
+    MatchSnapshot::write(world, data->data());
+    lastSaveNs = timer.nsecsElapsed();
+    if (wait) return writeSaveFile(path, *data);
+
+    savePool.start([this, path, data]() {
+        writeSaveFile(path, *data);
+        saveInFlight.store(false);
+    });
+    return true;
+}
+
+bool GameScreen::resumeMatch(const QString &path) {
+    if (gameOverEmitted) return false;
+    QElapsedTimer timer;
+    timer.start();
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    uchar *data = file.map(0, file.size());
+    if (!data) {
+        qWarning() << "无法读取存档:" << path;
+        return false;
+    }
+
+    // 读进模拟线程自己的世界，停止期间不会与模拟线程冲突
+    simulation.stop();
+    SimWorld &simWorld = simulation.world();
+    SimWorld previous = simWorld;
+    std::string error;
+    bool restored = MatchSnapshot::restore(reinterpret_cast<const char *>(data), file.size(), simWorld, &error);
+    file.unmap(data);
+    if (restored && simWorld.playerCount != setup.players) {
+        error = "存档人数与本局不一致";
+        restored = false;
+    }
+    if (!restored) {
+        simWorld = previous;
+        if (!isSuspended()) simulation.start();
+        qWarning() << "读档失败:" << QString::fromStdString(error);
+        return false;
     }
+
+    simulation.worldRestored();
+    world = simWorld;
+    previousWorld = world;
+    simTickNs = world.tickUs * 1000LL;
+    resetViews();
+    if (!isSuspended()) simulation.start();
+    lastLoadNs = timer.nsecsElapsed();
+    return true;
 }
 
-void GameScreen::updateHealthBar(int player, int health) {
-    QLabel* bar = (player == 1) ? healthBar1 : healthBar2;
-    QLabel* text = (player == 1) ? healthText1 : healthText2;
+// 镜头
+void GameScreen::updateCamera(double smoothing, double alpha) {
+    double center = 0.0;
+    int counted = 0;
+    for (int i = 0; i < world.playerCount; i++) {
+        if (!world.isAlive(i)) continue;
+        const SimCharacter& from = previousWorld.characters[i];
+        const SimCharacter& to = world.characters[i];
+        center += from.x + (to.x - from.x) * alpha + to.width / 2.0;
+        counted++;
+    }
+    if (counted == 0) return;
+    center /= counted;
 
-    int width = (health * 200) / 100;
-    if (width < 0) width = 0;
+    int viewWidth = gameArea->width() > 0 ? gameArea->width() : world.level->width;
+    double target = center - viewWidth / 2.0;
+    target = qBound(0.0, target, static_cast<double>(qMax(0, world.level->width - viewWidth)));
+    cameraX += (target - cameraX) * smoothing;
+}
 
-    bar->setFixedWidth(width);
-    text->setText(QString::number(health));
+bool GameScreen::isOnScreen(int x, int w) const {
+    int left = viewLeft() - CULL_MARGIN;
+    int right = viewLeft() + gameArea->width() + CULL_MARGIN;
+    return x + w >= left && x <= right;
+}
 
-    if (health < 20) {
-        bar->setStyleSheet("background-color: yellow;");
+// 区块流式载入：只为镜头附近的区块绘制静态图层
+void GameScreen::updateChunks() {
+    const Level& level = *world.level;
+    int left = viewLeft();
+    int first = level.chunkAt(left - Level::CHUNK_WIDTH);
+    int last = level.chunkAt(left + gameArea->width() + Level::CHUNK_WIDTH);
+
+    for (auto it = chunkLayers.begin(); it != chunkLayers.end();) {
+        if (it.key() < first || it.key() > last) {
+            it = chunkLayers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    for (int c = first; c <= last; c++) {
+        if (!chunkLayers.contains(c)) {
+            chunkLayers.insert(c, renderChunkLayer(c));
+            staticLayerLeft = -1;
+        }
+    }
+}
+
+// 一个区块的平台和装饰物（区块坐标，高度与窗口相同）。
+// 跨区块的平台在各区块内分别绘制，边界处被裁掉；装饰物宽度不超过一个区块
+QImage GameScreen::renderChunkLayer(int chunk) const {
+    const Level& level = *world.level;
+    int x0 = chunk * Level::CHUNK_WIDTH;
+    QImage layer(Level::CHUNK_WIDTH, qMax(1, height()), QImage::Format_ARGB32_Premultiplied);
+    layer.fill(Qt::transparent);
+
+    QPainter painter(&layer);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::green);
+    painter.setBrush(QBrush(QColor(100, 200, 100, 150)));
+    for (int index : level.platformsInChunk(chunk)) {
+        const Platform& p = level.platforms[index];
+        painter.drawRect(p.x - x0, p.y, p.width, p.height);
+    }
+
+    // 装饰物原先放在游戏区域内，保持相同的纵向位置
+    int areaTop = gameArea->y();
+    for (int c = qMax(0, chunk - 1); c <= chunk; c++) {
+        for (int index : level.decorationsInChunk(c)) {
+            const Decoration& d = level.decorations[index];
+            if (d.x + d.width <= x0 || d.x >= x0 + Level::CHUNK_WIDTH) continue;
+            painter.drawPixmap(d.x - x0, d.y + areaTop, d.width, d.height, decorationPixmaps[d.kind]);
+        }
+    }
+    return layer;
+}
+
+// 镜头位置变化或区块更新时重新合成；镜头不动时直接复用
+void GameScreen::updateStaticLayer() {
+    int left = viewLeft();
+    if (staticLayerLeft == left && staticLayer.size() == size()) return;
+
+    if (backgroundLayer.size() != size() && !backgroundSource.isNull()) {
+        backgroundLayer = backgroundSource.scaled(size(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation)
+                              .toImage().convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    }
+    if (staticLayer.size() != size()) staticLayer = QImage(size(), QImage::Format_ARGB32_Premultiplied);
+
+    // 绘制列表：背景在最下层，其上是镜头内的区块
+    renderList.clear();
+    if (!backgroundLayer.isNull()) {
+        renderList.append(TileRenderer::Command::draw(0, 0, backgroundLayer));
     } else {
-        bar->setStyleSheet("background-color: red;");
+        renderList.append(TileRenderer::Command::fill(staticLayer.rect(), Qt::black));
+    }
+    for (auto it = chunkLayers.constBegin(); it != chunkLayers.constEnd(); ++it) {
+        int x = it.key() * Level::CHUNK_WIDTH - left;
+        if (x + Level::CHUNK_WIDTH <= 0 || x >= width()) continue;
+        renderList.append(TileRenderer::Command::draw(x, 0, it.value()));
     }
+    rasterizer.render(renderList, staticLayer);
+    staticLayerLeft = left;
+}
+
+void GameScreen::invalidateStaticLayer() {
+    chunkLayers.clear();
+    backgroundLayer = QImage();
+    staticLayerLeft = -1;
 }
 
-// 攻击检测
-void GameScreen::checkAttack() {
-    QRect charRect1(character1->getX(), character1->getY(),
-                    character1->getWidth(), character1->getHeight());
-    QRect charRect2(character2->getX(), character2->getY(),
-                    character2->getWidth(), character2->getHeight());
+// 显示帧
+void GameScreen::frameTick() {
+    qint64 now = frameClock.nsecsElapsed();
+    qint64 frameNs = now - lastFrameNs;
+    lastFrameNs = now;
+    frameTimes[frameTimeNext] = frameNs;
+    frameTimeNext = (frameTimeNext + 1) % FRAME_HISTORY;
+    frameTimeCount = qMin(frameTimeCount + 1, FRAME_HISTORY);
+    particles->beginFrame();
+
+    // 模拟在独立线程上按固定步长推进，这里只取最新发布的一帧
+    receiveFrame();
+    if (world.isOver() && !gameOverEmitted) {
+        gameOverEmitted = true;
+        frameTimer->stop();
+        autosaveTimer->stop();
+        savePool.waitForDone();     // 还在写的存档不能在删除之后落盘
+        QFile::remove(QUICKSAVE_FILE);
+        simulation.stop();
+        syncViews(1.0);
+        emit gameOver(world.winner());
+    }
+    if (gameOverEmitted) return;
+
+    // 插值比例：距最新一帧的计划时刻经过了多少个模拟帧
+    const SimulationThread::Frame& frame = simulation.frame();
+    double alpha = qBound(0.0, static_cast<double>(SimulationThread::nowNs() - frame.tickNs) / simTickNs, 1.0);
+    frameAllocations.begin(tickArena);
+    updateCamera(1.0 - std::exp(-frameNs / 150e6), alpha);
+    updateChunks();
+    syncViews(alpha);
+    frameAllocations.end(tickArena);
+    tickArena.reset();
 
-    // 玩家1攻击检测
-    if (character1->getAttackEffect()->isVisible() || character1->getKnifeEffect()->isVisible()) {
-        QRect attackRange = character1->getAttackRange();
-        if (attackRange.intersects(charRect2)) {
-            bool shooterCrouching = character1->isCharacterCrouching();
-            bool targetCrouching = character2->isCharacterCrouching();
-            if (shooterCrouching || !targetCrouching) {
-                int damage = (character1->getCurrentWeapon() == Character::FIST) ? 2 : 5;
-                character2->takeDamage(damage, character1->getCurrentWeapon());
+    // 压力测试：同步绘制，模拟和绘制在不同线程上并行，取两者中较长的耗时交给加压过程
+    if (stressRamp) {
+        repaint();
+        stressRamp->addFrame(qMax(frameClock.nsecsElapsed() - now, frame.stepNs));
+        if (stressRamp->finished()) {
+            StressTest::printResults(stressRamp->results(), false);
+            if (!StressTest::writeCsv(stressOptions.outputPath, stressRamp->results(), false)) {
+                qWarning() << "无法写入" << QString::fromStdString(stressOptions.outputPath);
             }
+            stressRamp.reset();
+            emit stressFinished();
         }
+        return;
     }
-
-    // 其他攻击检测...
+    update();
 }
 
-void GameScreen::checkGameOver() {
-    if (character1->getHealth() <= 0) {
-        emit gameOver(2);
-    } else if (character2->getHealth() <= 0) {
-        emit gameOver(1);
+// 接收模拟帧：取出到这一帧为止的对战事件更新血条、产生特效（显示跟不上时一并处理中间帧的事件），
+// 粒子和动画按经过的模拟帧数推进
+void GameScreen::receiveFrame() {
+    if (!simulation.update()) return;
+    const SimulationThread::Frame& frame = simulation.frame();
+    if (stressRamp) applyStressLoad();
+
+    tickAllocations.begin(tickArena);
+    int ticks = static_cast<int>(frame.current.tick - world.tick);
+    int stepMs = ticks > 0 ? static_cast<int>((frame.current.elapsedMs - world.elapsedMs) / ticks) : 0;
+    previousWorld = frame.previous;
+    world = frame.current;
+    dispatchEvents(world);
+    for (int i = 0; i < qMin(ticks, MAX_TICKS_PER_FRAME); i++) {
+        particles->step(stepMs);
+        animator.step(stepMs);
     }
+    tickAllocations.end(tickArena);
+    tickArena.reset();
+}
+
+namespace {
+// 位移超过该距离视为瞬移（跌落复位等），不做插值
+const int SNAP_DISTANCE = 200;
+
+int lerp(int from, int to, double alpha) {
+    if (qAbs(to - from) > SNAP_DISTANCE) return to;
+    return from + qRound((to - from) * alpha);
+}
+
+// 按编号排序的 (编号, 下标) 表，在帧内临时内存上构建，用于在另一帧的世界中查找同一实体
+using IdIndex = std::pmr::vector<std::pair<int, int>>;
+
+template <class Entity>
+IdIndex indexById(const std::pmr::vector<Entity> &entities, std::pmr::memory_resource *memory) {
+    IdIndex index(memory);
+    index.reserve(entities.size());
+    for (int i = 0; i < static_cast<int>(entities.size()); i++) index.emplace_back(entities[i].id, i);
+    std::sort(index.begin(), index.end());
+    return index;
+}
+
+// 编号对应的下标，没有时返回 -1
+int findId(const IdIndex &index, int id) {
+    auto it = std::lower_bound(index.begin(), index.end(), std::make_pair(id, INT_MIN));
+    return it != index.end() && it->first == id ? it->second : -1;
+}
 }
 
-// 道具拾取检测
-void GameScreen::checkItemPickup(Character* character) {
-    int charX = character->getX();
-    int charY = character->getY();
-    int charWidth = character->getWidth();
-    int charHeight = character->getHeight();
-    int pickupX = charX + charWidth / 2;
-    int pickupY = charY + charHeight - 10;
+// 本次取出的事件按固定顺序分发：先更新受影响玩家的血条（每人一次），再产生特效，
+// 同一玩家的多次回血合并为一个数字。队列曾满丢弃过事件时刷新全部血条
+void GameScreen::dispatchEvents(const SimWorld& to) {
+    std::pmr::vector<SimEvent> events(&tickArena);
+    SimEvent event;
+    while (simulation.takeEvent(to.tick, event)) events.push_back(event);
 
-    for (int i = items.size() - 1; i >= 0; i--) {
-        Item* item = items[i];
-        if (item->contains(pickupX, pickupY)) {
-            switch (item->getType()) {
-            case Item::BANDAGE:
-                character->heal(20);
-                showHealEffect(character, "+20 HP");
-                break;
-            case Item::MEDKIT:
-                character->fullHeal();
-                showHealEffect(character, "+100 HP");
-                break;
-                // 其他道具处理...
+    uint64_t dropped = simulation.droppedEvents();
+    bool refreshAll = dropped != reportedDroppedEvents;
+    reportedDroppedEvents = dropped;
+
+    bool touched[SimWorld::MAX_PLAYERS] = {};
+    int healed[SimWorld::MAX_PLAYERS] = {};
+    for (const SimEvent& e : events) {
+        if (e.type == SimEvent::DAMAGE || e.type == SimEvent::HEAL || e.type == SimEvent::DEATH) touched[e.player] = true;
+        if (e.type == SimEvent::HEAL) healed[e.player] += e.value;
+    }
+    for (int i = 0; i < to.playerCount && i < huds.size(); i++) {
+        if (refreshAll || touched[i]) updateHealthBar(i + 1, to.characters[i].health);
+    }
+
+    for (const SimEvent& e : events) {
+        const SimCharacter& c = to.characters[e.player];
+        int centerX = c.x + c.width / 2;
+        int chestY = c.y + c.height / 3;
+        switch (e.type) {
+        case SimEvent::DAMAGE:
+            if (e.value > 0) {
+                particles->spawn(ParticleSystem::SPARK, centerX, chestY, qMin(40, 10 + e.value / 2));
+            } else if (e.flags & SimEvent::ARMOR_ABSORBED) {
+                particles->spawn(ParticleSystem::DEBRIS, centerX, chestY, 6);
             }
-            item->deleteLater();
-            items.removeAt(i);
+            if (e.flags & SimEvent::ARMOR_BROKEN) {
+                particles->spawn(ParticleSystem::DEBRIS, centerX, chestY, 30);
+            }
+            break;
+        case SimEvent::PICKUP:
+            particles->spawn(ParticleSystem::GLINT, e.x, e.y, 16);
+            break;
+        default:
             break;
         }
     }
+    for (int i = 0; i < to.playerCount; i++) {
+        if (healed[i] > 0) showHealEffect(to.characters[i], QString("+%1").arg(healed[i]));
+    }
+}
+
+// 攻击特效的命中帧：在特效中心迸出火花
+void GameScreen::onEffectEvent(QWidget* effect, const QString& name) {
+    if (name != "impact") return;
+    QPoint center = effect->geometry().center();
+    particles->spawn(ParticleSystem::SPARK, center.x() + viewLeft(), center.y(), 8);
+}
+
+void GameScreen::showHealEffect(const SimCharacter& c, const QString& text) {
+    particles->spawn(ParticleSystem::HEAL, c.x + c.width / 2, c.y + c.height / 2, 20);
+    particles->spawnText(text, c.x + c.width / 2 - 10, c.y - 10, QColor(80, 230, 120));
+}
+
+// 同步显示控件：位置换算为镜头坐标，镜头外的道具和投射物不创建控件
+void GameScreen::syncViews(double alpha) {
+    int left = viewLeft();
+    particles->setCameraLeft(left);
+    for (int i = 0; i < characters.size(); i++) {
+        if (i >= world.playerCount) { // 压力测试减少人数时多出的角色
+            characters[i]->hide();
+            continue;
+        }
+        const SimCharacter& from = previousWorld.characters[i];
+        const SimCharacter& to = world.characters[i];
+        characters[i]->syncFromState(to, lerp(from.x, to.x, alpha) - left, lerp(from.y, to.y, alpha));
+    }
+
+    // 道具：进入镜头的创建控件，已拾取或离开镜头的删除
+    IdIndex previous = indexById(previousWorld.items, &tickArena);
+    std::pmr::vector<int> alive(&tickArena);
+    for (const SimItem& item : world.items) {
+        if (!isOnScreen(item.x, SimItem::SIZE)) continue;
+        Item* view = itemViews.value(item.id);
+        if (!view) {
+            view = new Item(static_cast<Item::ItemType>(item.type), gameArea);
+            view->show();
+            view->raise();
+            particles->raise();
+            itemViews.insert(item.id, view);
+        }
+        int x = item.x, y = item.y;
+        int oldIndex = findId(previous, item.id);
+        if (oldIndex >= 0) {
+            const SimItem& old = previousWorld.items[oldIndex];
+            x = lerp(old.x, item.x, alpha);
+            y = lerp(old.y, item.y, alpha);
+        }
+        view->move(x - left, y);
+        alive.push_back(item.id);
+    }
+    std::sort(alive.begin(), alive.end());
+    for (auto it = itemViews.begin(); it != itemViews.end();) {
+        if (!std::binary_search(alive.begin(), alive.end(), it.key())) {
+            it.value()->deleteLater();
+            it = itemViews.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // 投射物
+    previous = indexById(previousWorld.projectiles, &tickArena);
+    alive.clear();
+    for (const SimProjectile& p : world.projectiles) {
+        if (!isOnScreen(p.x, p.width)) continue;
+        QWidget* view = projectileViews.value(p.id);
+        if (!view) {
+            if (p.kind == SimProjectile::BALL) {
+                view = new BallProjectile(gameArea);
+            } else {
+                view = new Bullet(p.velocityX > 0, p.width, p.height, gameArea);
+            }
+            view->show();
+            view->raise();
+            particles->raise();
+            projectileViews.insert(p.id, view);
+        }
+        int x = p.x, y = p.y;
+        int oldIndex = findId(previous, p.id);
+        if (oldIndex >= 0) {
+            const SimProjectile& old = previousWorld.projectiles[oldIndex];
+            x = lerp(old.x, p.x, alpha);
+            y = lerp(old.y, p.y, alpha);
+        }
+        view->move(x - left, y);
+        alive.push_back(p.id);
+    }
+    std::sort(alive.begin(), alive.end());
+    for (auto it = projectileViews.begin(); it != projectileViews.end();) {
+        if (!std::binary_search(alive.begin(), alive.end(), it.key())) {
+            it.value()->deleteLater();
+            it = projectileViews.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+// 血条宽度：人数多、窗口窄时缩短，最长200
+void GameScreen::layoutHud() {
+    int available = qMax(0, topBar->width() - 40);
+    if (available == 0) available = 1160; // 尚未布局时按默认窗口宽度
+    hudBarWidth = qBound(40, available / static_cast<int>(huds.size()) - 14, 200);
+    for (int i = 0; i < huds.size(); i++) {
+        const PlayerHud& hud = huds[i];
+        hud.container->setFixedSize(hudBarWidth + 4, 24);
+        hud.text->setGeometry(0, 0, hudBarWidth, 20);
+        updateHealthBar(i + 1, world.characters[i].health);
+    }
+}
+
+void GameScreen::updateHealthBar(int player, int health) {
+    const PlayerHud& hud = huds[player - 1];
+    QLabel* bar = hud.bar;
+    QLabel* text = hud.text;
+
+    int width = (health * hudBarWidth) / 100;
+    if (width < 0) width = 0;
+
+    bar->setGeometry(2, 2, width, 20);
+    text->setText(huds.size() > 2 ? QString("P%1 %2").arg(player).arg(health) : QString::number(health));
+
+    if (health < 20) {
+        bar->setStyleSheet("background-color: yellow;");
+    } else {
+        bar->setStyleSheet("background-color: red;");
+    }
 }
 
 // 绘制游戏界面
 void GameScreen::paintEvent(QPaintEvent *event) {
+    // 正在显示的这一帧之前采样的输入已反映到画面上
+    int64_t presentUs = LatencyProbe::nowUs();
+    LatencyProbe::Event sampled;
+    while (simulation.takeSampled(world.tick, sampled)) {
+        latency.markPresent(sampled, presentUs);
+    }
+
     QWidget::paintEvent(event);
+
+    // 背景、平台和装饰物：一次不透明拷贝
+    updateStaticLayer();
     QPainter painter(this);
+    painter.drawImage(0, 0, staticLayer);
     painter.setRenderHint(QPainter::Antialiasing);
 
-    // 绘制平台
-    painter.setPen(Qt::green);
-    painter.setBrush(QBrush(QColor(100, 200, 100, 150)));
-    for (const Platform& p : platforms) {
-        painter.drawRect(p.x, p.y, p.width, p.height);
+    int left = viewLeft();
+
+    // 狙击弹道：随剩余时间淡出，打中角色时为红色
+    for (int i = 0; i < world.playerCount; i++) {
+        const SimTracer& tracer = world.tracers[i];
+        if (tracer.remainingMs <= 0) continue;
+        QColor color = tracer.hit ? QColor(255, 80, 60) : QColor(255, 240, 180);
+        color.setAlpha(255 * tracer.remainingMs / SimWorld::TRACER_MS);
+        painter.setPen(QPen(color, 2));
+        painter.drawLine(tracer.x0 - left, tracer.y0, tracer.x1 - left, tracer.y1);
     }
 
-    // 绘制调试信息
-    if (character1->isCharacterCrouching()) {
-        painter.setPen(Qt::red);
-        painter.drawText(10, 70, "玩家1: 下蹲状态");
+    // 绘制调试信息：每名玩家一行下蹲状态，之后依次是电脑对手和帧统计
+    int textY = 70;
+    for (int i = 0; i < world.playerCount; i++, textY += 20) {
+        if (!world.characters[i].crouching) continue;
+        painter.setPen(setup.players > 2 ? playerColor(i) : QColor(i == 0 ? Qt::red : Qt::blue));
+        painter.drawText(10, textY, QString("玩家%1: 下蹲状态").arg(i + 1));
     }
-    if (character2->isCharacterCrouching()) {
-        painter.setPen(Qt::blue);
-        painter.drawText(10, 90, "玩家2: 下蹲状态");
+
+    // 绘制电脑对手状态
+    static const char* difficultyNames[] = { "简单", "普通", "困难" };
+    painter.setPen(Qt::yellow);
+    for (BotController* bot : bots) {
+        if (!bot) continue;
+        painter.drawText(10, textY, QString("电脑对手 玩家%1(%2): %3 节点/秒")
+                                        .arg(bot->player())
+                                        .arg(difficultyNames[bot->difficulty()])
+                                        .arg(bot->nodesPerSecond(), 0, 'f', 0));
+        textY += 20;
     }
 
-    // 绘制攻击范围
+    // 绘制近战判定框：当前武器时间轴上的全部判定框，正在生效的填充显示
     if (drawAttackRange) {
         painter.setPen(Qt::red);
+        for (int i = 0; i < world.playerCount; i++) {
+            const SimCharacter& c = world.characters[i];
+            if (!world.isAlive(i)) continue;
+            const MeleeTimeline& timeline = SimWorld::meleeTimeline(c.weapon);
+            int elapsedMs = timeline.durationMs - c.meleeRemainingMs;
+            for (int h = 0; h < timeline.count; h++) {
+                const MeleeHitbox& box = timeline.hitboxes[h];
+                bool active = c.meleeRemainingMs > 0 && elapsedMs >= box.startMs && elapsedMs < box.endMs;
+                painter.setBrush(active ? QColor(255, 0, 0, 100) : QColor(Qt::transparent));
+                int rx, ry, rw, rh;
+                SimWorld::hitboxRect(c, box, rx, ry, rw, rh);
+                painter.drawRect(rx - left, ry, rw, rh);
+            }
+        }
         painter.setBrush(Qt::NoBrush);
-        painter.drawRect(character1->getAttackRange());
-        painter.drawRect(character2->getAttackRange());
     }
 
     // 绘制状态提示
-    if (character1->isInvincibleState()) {
-        painter.setPen(Qt::red);
-        painter.drawText(character1->getX(), character1->getY() - 20, "无敌");
+    for (int i = 0; i < world.playerCount; i++) {
+        const SimCharacter& state = world.characters[i];
+        if (!world.isAlive(i)) continue;
+        if (state.invincibleMs > 0) {
+            painter.setPen(Qt::red);
+            painter.drawText(state.x - left, state.y - 20, "无敌");
+        }
+
+        // 绘制武器状态
+        if (state.weapon == SimCharacter::KNIFE) {
+            painter.setPen(Qt::white);
+            painter.drawText(state.x - left, state.y - 60, "装备: 小刀");
+        }
+        // 其他状态绘制...
     }
-    if (character2->isInvincibleState()) {
-        painter.setPen(Qt::red);
-        painter.drawText(character2->getX(), character2->getY() - 20, "无敌");
+
+    if (showLatency) {
+        drawLatencyHistogram(painter);
+    }
+
+    if (showMemory) {
+        drawMemoryOverlay(painter);
+    }
+
+    // 帧间隔统计
+    if (showFrameStats) {
+        drawTileStats(painter);
+        double meanMs, stdDevMs, maxMs;
+        frameTimeStats(meanMs, stdDevMs, maxMs);
+        painter.setPen(Qt::yellow);
+        painter.drawText(10, textY, QString("显示 %1 fps  帧间隔 平均 %2ms  标准差 %3ms  最大 %4ms  模拟 %5 Hz")
+                                     .arg(meanMs > 0 ? 1000.0 / meanMs : 0.0, 0, 'f', 1)
+                                     .arg(meanMs, 0, 'f', 2)
+                                     .arg(stdDevMs, 0, 'f', 2)
+                                     .arg(maxMs, 0, 'f', 2)
+                                     .arg(1e9 / simTickNs, 0, 'f', 1));
+        painter.drawText(10, textY + 20, QString("粒子 %1/%2  已丢弃 %3")
+                                     .arg(particles->count())
+                                     .arg(ParticleSystem::CAPACITY)
+                                     .arg(particles->dropped()));
+        // 堆的统计需要 CONFIG+=heap_counter 构建
+        auto heapText = [](const AllocationMeter &meter) {
+            if (!AllocationMeter::countsHeap()) return QString("n/a");
+            return QString("%1 B（%2 次）").arg(meter.heapBytes(), 0, 'f', 0).arg(meter.heapAllocations(), 0, 'f', 1);
+        };
+        painter.drawText(10, textY + 40, QString("临时分配 模拟帧 arena %1 B / 堆 %2  显示帧 arena %3 B / 堆 %4")
+                                     .arg(tickAllocations.arenaBytes(), 0, 'f', 0)
+                                     .arg(heapText(tickAllocations))
+                                     .arg(frameAllocations.arenaBytes(), 0, 'f', 0)
+                                     .arg(heapText(frameAllocations)));
+        qint64 wallNs = rasterizer.wallNs();
+        painter.drawText(10, textY + 60, QString("静态图层光栅化 %1 线程  %2 个图块  耗时 %3ms  图块合计 %4ms  并行加速 %5x（F8 切换线程数）")
+                                     .arg(rasterizer.threadCount())
+                                     .arg(rasterizer.tiles().size())
+                                     .arg(wallNs / 1e6, 0, 'f', 2)
+                                     .arg(rasterizer.tileSumNs() / 1e6, 0, 'f', 2)
+                                     .arg(wallNs > 0 ? static_cast<double>(rasterizer.tileSumNs()) / wallNs : 0.0, 0, 'f', 1));
+        painter.drawText(10, textY + 80, QString("存档 %1ms  读档 %2ms（F9 存档，F10 读档）")
+                                     .arg(lastSaveNs / 1e6, 0, 'f', 3)
+                                     .arg(lastLoadNs / 1e6, 0, 'f', 3));
+        if (telemetry) {
+            painter.drawText(10, textY + 100, QString("遥测 已写入 %1 条  丢弃 %2 条")
+                                         .arg(telemetry->written())
+                                         .arg(telemetry->dropped()));
+        }
+    }
+
+    if (suspendReasons & (SUSPEND_PAUSED | SUSPEND_INACTIVE)) {
+        QFont font = painter.font();
+        font.setPointSize(24);
+        painter.setFont(font);
+        painter.setPen(Qt::white);
+        painter.drawText(rect(), Qt::AlignCenter,
+                         (suspendReasons & SUSPEND_PAUSED) ? "已暂停（按 P 继续）" : "已暂停（窗口未激活）");
+    }
+}
+
+void GameScreen::frameTimeStats(double &meanMs, double &stdDevMs, double &maxMs) const {
+    meanMs = stdDevMs = maxMs = 0.0;
+    if (frameTimeCount == 0) return;
+    double sum = 0.0, sumSq = 0.0;
+    for (int i = 0; i < frameTimeCount; i++) {
+        double ms = frameTimes[i] / 1e6;
+        sum += ms;
+        sumSq += ms * ms;
+        maxMs = qMax(maxMs, ms);
+    }
+    meanMs = sum / frameTimeCount;
+    stdDevMs = std::sqrt(qMax(0.0, sumSq / frameTimeCount - meanMs * meanMs));
+}
+
+// 绘制输入延迟直方图（键盘事件到画面更新，每格1毫秒）
+void GameScreen::drawLatencyHistogram(QPainter &painter) {
+    const int barWidth = 4;
+    const int chartHeight = 100;
+    int left = 10;
+    int bottom = height() - 30;
+
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(0, 0, 0, 160));
+    painter.drawRect(left - 5, bottom - chartHeight - 45, LatencyProbe::BUCKET_COUNT * barWidth + 10, chartHeight + 70);
+
+    int64_t peak = latency.maxBucket();
+    const int64_t* buckets = latency.histogram();
+    painter.setBrush(QColor(100, 200, 255));
+    for (int i = 0; i < LatencyProbe::BUCKET_COUNT && peak > 0; i++) {
+        int h = static_cast<int>(buckets[i] * chartHeight / peak);
+        painter.drawRect(left + i * barWidth, bottom - h, barWidth - 1, h);
+    }
+
+    // 一个模拟帧长的参考线
+    painter.setPen(Qt::red);
+    int frameX = left + world.tickUs / LatencyProbe::BUCKET_US * barWidth;
+    painter.drawLine(frameX, bottom - chartHeight, frameX, bottom);
+
+    painter.setPen(Qt::white);
+    painter.drawText(left, bottom - chartHeight - 25,
+                     QString("输入延迟 %1 次  平均 %2ms  P50 %3ms  P95 %4ms  最大 %5ms")
+                         .arg(latency.count())
+                         .arg(latency.meanUs() / 1000.0, 0, 'f', 1)
+                         .arg(latency.percentileUs(0.50) / 1000)
+                         .arg(latency.percentileUs(0.95) / 1000)
+                         .arg(latency.maxUs() / 1000.0, 0, 'f', 1));
+    painter.drawText(left, bottom + 18, "0ms");
+    painter.drawText(left + LatencyProbe::BUCKET_COUNT * barWidth - 40, bottom + 18,
+                     QString("%1ms+").arg(LatencyProbe::BUCKET_COUNT - 1));
+}
+
+// 右上角的内存统计，扫描全部控件开销较大，按固定间隔刷新
+void GameScreen::drawMemoryOverlay(QPainter &painter) {
+    if (!memoryRefresh.isValid() || memoryRefresh.elapsed() >= MEMORY_REFRESH_MS) {
+        memoryLines = MemoryStats::collect().overlayLines();
+        memoryRefresh.start();
     }
 
-    // 绘制武器状态
+    const int lineHeight = 16;
+    const int panelWidth = 360;
+    int left = width() - panelWidth - 10;
+    int top = 60;
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(0, 0, 0, 170));
+    painter.drawRect(left, top, panelWidth, memoryLines.size() * lineHeight + 10);
     painter.setPen(Qt::white);
-    if (character1->getCurrentWeapon() == Character::KNIFE) {
-        painter.drawText(character1->getX(), character1->getY() - 60, "装备: 小刀");
+    for (int i = 0; i < memoryLines.size(); i++) {
+        painter.drawText(left + 8, top + (i + 1) * lineHeight, memoryLines[i]);
+    }
+}
+
+// 图块边框和最近一次合成的耗时（微秒），颜色区分绘制该图块的线程
+void GameScreen::drawTileStats(QPainter &painter) {
+    painter.setBrush(Qt::NoBrush);
+    for (const TileRenderer::Tile &tile : rasterizer.tiles()) {
+        QColor color = PLAYER_COLORS[tile.worker % SimWorld::MAX_PLAYERS];
+        color.setAlpha(120);
+        painter.setPen(color);
+        painter.drawRect(tile.rect.adjusted(0, 0, -1, -1));
+        painter.drawText(tile.rect.x() + 4, tile.rect.bottom() - 4, QString::number(tile.ns / 1000));
     }
-    // 其他状态绘制...
+}
+
+void GameScreen::cycleRasterThreads() {
+    int ideal = qMax(1, QThread::idealThreadCount());
+    int threads = rasterizer.threadCount() >= ideal ? 1 : qMin(ideal, rasterizer.threadCount() * 2);
+    rasterizer.setThreadCount(threads);
+    staticLayerLeft = -1;
+    update();
+}
+
+void GameScreen::reportMemory(MemoryStats &stats) const {
+    stats.addPixmap("<背景>", backgroundSource);
+    stats.addImage("<背景（窗口尺寸）>", backgroundLayer);
+    stats.addImage("<静态图层>", staticLayer);
+    for (auto it = chunkLayers.constBegin(); it != chunkLayers.constEnd(); ++it) {
+        stats.addImage("<区块图层>", it.value());
+    }
+    stats.addPixmap(":/new/prefix1/res/grass.png", decorationPixmaps[Decoration::GRASS]);
+    stats.addPixmap(":/new/prefix1/res/xuedui.png", decorationPixmaps[Decoration::SNOW]);
+
+    // 前后两帧世界各有一份道具和投射物
+    const SimWorld* worlds[] = { &world, &previousWorld };
+    for (const SimWorld* w : worlds) {
+        stats.addStore("SimWorld.items", w->items.size(), w->items.capacity(), sizeof(SimItem));
+        stats.addStore("SimWorld.projectiles", w->projectiles.size(), w->projectiles.capacity(), sizeof(SimProjectile));
+    }
+    stats.addStore("itemViews", itemViews.size(), itemViews.capacity(), sizeof(Item*));
+    stats.addStore("projectileViews", projectileViews.size(), projectileViews.capacity(), sizeof(QWidget*));
+    stats.addStore("particles", particles->count(), ParticleSystem::CAPACITY,
+                   sizeof(ParticleSystem) / ParticleSystem::CAPACITY);
+    stats.addStore("animator", animator.liveCount(), animator.capacity(), sizeof(AnimationPlayer));
+    stats.addStore("simulation.replayTrace", simulation.frame().replayEvents, simulation.frame().replayCapacity,
+                   sizeof(LatencyProbe::Event));
+    stats.addStore("tickArena", tickArena.peakBytes(), tickArena.capacity(), 1);
+    stats.addStore("stressEffects", std::count_if(stressEffects.begin(), stressEffects.end(),
+                                                  [](AttackEffect* e) { return e->isVisible(); }),
+                   stressEffects.size(), sizeof(AttackEffect));
+}
+
+// 导出到当前目录：latency.csv 为延迟样本，latency_replay.csv 可用 --replay 无界面回放
+// 回放记录在模拟线程上，导出期间暂停模拟
+void GameScreen::exportLatency() {
+    bool running = simulation.isRunning();
+    simulation.stop();
+
+    LatencyProbe::ReplayHeader header;
+    header.seed = matchSeed;
+    header.level = world.level->name;
+    header.spawnTick = simulation.spawnTick();
+    header.players = world.playerCount;
+    header.teams = setup.teams;
+    header.tickUs = world.tickUs;
+    for (int i = 0; i < world.playerCount; i++) {
+        header.width[i] = world.characters[i].width;
+        header.height[i] = world.characters[i].height;
+    }
+    // 读档继续的对战无法从种子重现，只导出延迟统计
+    bool replay = simulation.replayUsable();
+    if (!latency.writeCsv("latency.csv") || (replay && !simulation.probe().writeReplay("latency_replay.csv", header))) {
+        qWarning() << "无法导出输入延迟数据";
+    } else if (!replay) {
+        qWarning() << "本局由存档继续，未导出回放";
+    } else if (simulation.probe().replayTruncated()) {
+        qWarning() << "回放记录已满，只导出了前" << simulation.probe().replayTrace().size() << "个输入事件";
+    }
+    if (running) simulation.start();
+}
+
+// 按键映射
+bool GameScreen::mapKey(int key, int &player, InputBit &bit) const {
+    auto it = keyBindings.constFind(key);
+    if (it == keyBindings.constEnd()) return false;
+    player = it->player;
+    bit = it->bit;
+    return true;
+}
+
+void GameScreen::setKeyBinding(int key, int player, InputBit bit) {
+    if (player < 1 || player > setup.players) return;
+    keyBindings.insert(key, KeyBinding{ player, bit });
+}
+
+QColor GameScreen::playerColor(int index) const {
+    return PLAYER_COLORS[setup.teams > 0 ? index % setup.teams : index];
+}
+
+// 玩家输入处理：投递给模拟线程，由下一帧模拟统一采样
+void GameScreen::applyPlayerInput(int player, InputBit bit, bool pressed) {
+    feedInput(player, bit, pressed, false, LatencyProbe::nowUs());
+}
+
+void GameScreen::feedInput(int player, InputBit bit, bool pressed, bool measured, int64_t timeUs) {
+    SimulationThread::Command command;
+    command.type = pressed ? SimulationThread::Command::PRESS : SimulationThread::Command::RELEASE;
+    command.player = static_cast<uint8_t>(player);
+    command.bit = bit;
+    command.measured = measured;
+    command.timeUs = timeUs;
+    if (!simulation.post(command)) qWarning() << "输入队列已满，丢弃按键事件";
 }
 
 // 键盘事件处理
 void GameScreen::keyPressEvent(QKeyEvent *event) {
+    int64_t timeUs = LatencyProbe::nowUs(); // 尽早记录事件时刻
+    int player;
+    InputBit bit;
+    if (mapKey(event->key(), player, bit)) {
+        if (!event->isAutoRepeat() && !bots[player - 1]) {
+            feedInput(player, bit, true, true, timeUs);
+        }
+        return;
+    }
+
     switch (event->key()) {
-    case Qt::Key_A: character1->setMoveDirection(-1); break;
-    case Qt::Key_D: character1->setMoveDirection(1); break;
-    case Qt::Key_W: character1->jump(); break;
-    case Qt::Key_S:
-        character1->setCrouching(true);
-        checkItemPickup(character1);
-        break;
-    case Qt::Key_F: character1->attack(); break;
-    case Qt::Key_Left: character2->setMoveDirection(-1); break;
-    case Qt::Key_Right: character2->setMoveDirection(1); break;
-    case Qt::Key_Up: character2->jump(); break;
-    case Qt::Key_Down:
-        character2->setCrouching(true);
-        checkItemPickup(character2);
-        break;
-    case Qt::Key_L: character2->attack(); break;
     case Qt::Key_R: drawAttackRange = !drawAttackRange; update(); break;
+    case Qt::Key_B: cycleBot(); break;
+    case Qt::Key_F3: showLatency = !showLatency; update(); break;
+    case Qt::Key_F4: exportLatency(); break;
+    case Qt::Key_F5: showFrameStats = !showFrameStats; break;
+    case Qt::Key_F6: cycleLevel(); break;
+    case Qt::Key_F7: showMemory = !showMemory; memoryRefresh.invalidate(); update(); break;
+    case Qt::Key_F8: cycleRasterThreads(); break;
+    case Qt::Key_F9: saveMatch(); break;
+    case Qt::Key_F10: resumeMatch(); break;
+    case Qt::Key_P: setSuspended(SUSPEND_PAUSED, !(suspendReasons & SUSPEND_PAUSED)); break;
     default: QWidget::keyPressEvent(event);
     }
 }
 
 void GameScreen::keyReleaseEvent(QKeyEvent *event) {
-    switch (event->key()) {
-    case Qt::Key_A:
-    case Qt::Key_D: character1->setMoveDirection(0); break;
-    case Qt::Key_S: character1->setCrouching(false); break;
-    case Qt::Key_Left:
-    case Qt::Key_Right: character2->setMoveDirection(0); break;
-    case Qt::Key_Down: character2->setCrouching(false); break;
-    default: QWidget::keyReleaseEvent(event);
+    int64_t timeUs = LatencyProbe::nowUs();
+    int player;
+    InputBit bit;
+    if (mapKey(event->key(), player, bit)) {
+        if (!event->isAutoRepeat() && !bots[player - 1]) {
+            feedInput(player, bit, false, false, timeUs);
+        }
+        return;
+    }
+    QWidget::keyReleaseEvent(event);
+}
+
+// 电脑对手切换
+void GameScreen::cycleBot() {
+    BotController*& bot = bots[1];
+    if (!bot) {
+        bot = new BotController(this, &botPool, 2, BotSearch::EASY, this);
+        if (isSuspended()) bot->stop();
+    } else if (bot->difficulty() == BotSearch::HARD) {
+        bot->stop();
+        SimulationThread::Command command;
+        command.type = SimulationThread::Command::CLEAR_INPUT;
+        command.player = static_cast<uint8_t>(bot->player());
+        simulation.post(command);
+        delete bot;
+        bot = nullptr;
+    } else {
+        bot->setDifficulty(static_cast<BotSearch::Difficulty>(bot->difficulty() + 1));
     }
+    update();
+}
+
+void GameScreen::cycleLevel() {
+    std::vector<std::string> names = Level::availableNames();
+    auto current = std::find(names.begin(), names.end(), world.level->name);
+    size_t next = current == names.end() ? 0 : (current - names.begin() + 1) % names.size();
+
+    QElapsedTimer loadTimer;
+    loadTimer.start();
+    std::shared_ptr<const Level> level = Level::byName(names[next]);
+    qint64 loadNs = loadTimer.nsecsElapsed();
+    if (!level) return;
+
+    bool spawning = world.spawning;
+    matchSeed = QRandomGenerator::global()->generate64();
+    loadLevel(level);
+    if (spawning) startSpawningItems();
+    qDebug() << "载入关卡" << QString::fromStdString(level->name) << loadNs / 1000 << "us";
+}
+
+void GameScreen::startStress(const StressTest::Options &options) {
+    stressOptions = options;
+    stressRamp.reset(new StressTest::Ramp(options));
+    setSuspended(SUSPEND_INACTIVE, false);
+    stressRng.reseed(options.seed);
+    for (int k = 0; k < StressTest::KIND_COUNT; k++) {
+        stressTargets[k].store(stressRamp->target(static_cast<StressTest::Kind>(k)), std::memory_order_relaxed);
+    }
+
+    // 实体在模拟线程上于每帧推进之前补足，使用独立的随机数序列
+    simulation.stop();
+    simulation.setPreTickHook([this, rng = SimRng(options.seed)](SimWorld& w) mutable {
+        for (int k = 0; k < StressTest::KIND_COUNT; k++) {
+            StressTest::maintain(w, static_cast<StressTest::Kind>(k), stressTargets[k].load(std::memory_order_relaxed), rng);
+        }
+    });
+    std::shared_ptr<const Level> level = Level::byName(options.level);
+    loadLevel(level ? level : Level::classic());
+}
+
+// 压力测试负载：道具、投射物和人数由模拟线程按目标数量补足，攻击特效控件播放完毕后换个位置重播
+void GameScreen::applyStressLoad() {
+    for (int k = 0; k < StressTest::KIND_COUNT; k++) {
+        stressTargets[k].store(stressRamp->target(static_cast<StressTest::Kind>(k)), std::memory_order_relaxed);
+    }
+
+    int effectCount = stressRamp->target(StressTest::EFFECTS);
+    while (stressEffects.size() < effectCount) {
+        stressEffects.append(new AttackEffect(&animator, &animations, gameArea));
+    }
+    for (int i = 0; i < stressEffects.size(); i++) {
+        AttackEffect* effect = stressEffects[i];
+        effect->syncAnimation();
+        if (i >= effectCount) {
+            effect->hide();
+        } else if (!effect->isVisible()) {
+            effect->startAttack(stressRng.bounded(0, 2) == 1,
+                                stressRng.bounded(0, qMax(1, gameArea->width() - 200)),
+                                stressRng.bounded(0, qMax(1, gameArea->height() - 200)), 64, 96);
+        } else {
+            effect->show();
+        }
+    }
+}
+
+// 电脑对手按人数分配推演线程
+int GameScreen::botCount() const {
+    return static_cast<int>(std::count_if(bots.begin(), bots.end(), [](BotController* bot) { return bot != nullptr; }));
+}
+
+// 复制正在显示的对战状态
+void GameScreen::captureWorld(SimWorld &snapshot) const {
+    snapshot = world;
 }
 
 void GameScreen::resizeEvent(QResizeEvent *event) {
     QWidget::resizeEvent(event);
-    if (background) {
-        background->setGeometry(0, 0, width(), height());
-    }
+    invalidateStaticLayer();
+    layoutHud();
+    particles->setGeometry(0, 0, gameArea->width(), gameArea->height());
+    updateCamera(1.0, 1.0);
+    updateChunks();
 }
@@ -4,9 +4,12 @@
 #include <QWidget>
 #include <QTimer>
 #include <QLabel>
-#include <vector>
-#include <QList>
+#include <QHash>
+#include <QVector>
 #include <QKeyEvent>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <memory>
 #include "Character.h"
 #include "Bullet.h"
 #include "BallProjectile.h"
@@ -14,109 +17,303 @@
 #include "Platform.h"
 #include "KnifeAttackEffect.h"
 #include "AttackEffect.h"
+#include "Simulation.h"
+#include "InputState.h"
+#include "LatencyProbe.h"
+#include "ParticleSystem.h"
+#include "StressTest.h"
+#include "Telemetry.h"
+#include "MemoryStats.h"
+#include "TickArena.h"
+#include "SimulationThread.h"
+#include "TileRenderer.h"
+#include <atomic>
 
-// 游戏界面类 - 处理键盘事件
-class GameScreen : public QWidget {
+class BotController;
+
+// 对战人数与分组
+struct MatchSetup {
+    int players = 2;        // 2 ~ SimWorld::MAX_PLAYERS
+    int teams = 0;          // 0=各自为战，否则玩家 i 属于第 i % teams 队
+    int humans = 2;         // 前几名玩家使用键盘，其余由电脑控制
+    int tickHz = 0;         // 模拟频率，0为默认（SimWorld::DEFAULT_TICK_US）
+};
+
+// 游戏界面类 - 处理键盘事件并交给模拟线程，模拟线程按固定帧推进 SimWorld，
+// 界面以显示刷新率绘制最新一帧与其上一帧之间的插值位置
+class GameScreen : public QWidget, public MemoryReporter {
     Q_OBJECT
 public:
-    GameScreen(QWidget *parent = nullptr);
-    ~GameScreen() {}
+    static constexpr int DEFAULT_DISPLAY_RATE = 60;   // 默认显示刷新率（Hz）
+    static constexpr int MAX_TICKS_PER_FRAME = 5;     // 每次绘制最多补推的粒子和动画帧数
+    static constexpr int FRAME_HISTORY = 120;         // 帧间隔统计的样本数
+    static constexpr int CULL_MARGIN = 100;           // 视野外仍保留控件的边距
+    static constexpr int KEYBOARD_PLAYERS = 3;        // 有默认键位的玩家数
+    static constexpr int AUTOSAVE_INTERVAL_MS = 5000; // 对战中自动存档的间隔
+    static constexpr const char *QUICKSAVE_FILE = "quicksave.snp"; // 快速存档（当前目录）
+
+    GameScreen(const MatchSetup &setup = MatchSetup(), QWidget *parent = nullptr);
+    ~GameScreen();
+
+    // 设置显示刷新率，与模拟频率无关
+    void setDisplayRate(int hz);
+
+    // 载入关卡（重置对战世界并清空已加载的区块）
+    void loadLevel(std::shared_ptr<const Level> level);
+
+    // 开始对战：电脑控制的玩家开始行动，并开始生成道具。
+    // resuming 时先读取快速存档，道具生成计时沿用存档；读档失败时照常开始
+    void startMatch(bool resuming = false);
 
     // 开始生成道具
     void startSpawningItems();
 
+    // 存档（F9）：把正在显示的对战世界写入固定布局的二进制文件（MatchSnapshot）。
+    // 对战开始后定时自动存档，关闭窗口时再存一次，对战结束后删除存档。
+    // 默认在后台线程写盘，返回是否已提交；wait 为 true 时等之前的存档写完，再在当前线程写完返回
+    bool saveMatch(const QString &path = QUICKSAVE_FILE, bool wait = false);
+
+    // 读档（F10）：映射存档文件，校验后直接恢复到模拟线程的世界；人数须与本局一致。
+    // 之前记录的回放随之作废，F4 只导出延迟统计
+    bool resumeMatch(const QString &path = QUICKSAVE_FILE);
+
     // 公开设置背景方法
     void setBackground(const QPixmap &pixmap);
 
+    // 玩家输入接口（键盘和电脑对手共用），player 从1开始
+    void applyPlayerInput(int player, InputBit bit, bool pressed);
+
+    // 设置按键绑定，覆盖该按键原有的绑定
+    void setKeyBinding(int key, int player, InputBit bit);
+
+    // 是否为组队对战（gameOver 的 winner 为队伍编号）
+    bool isTeamMatch() const { return setup.teams > 0; }
+
+    // 复制当前对战状态（供电脑对手推演）
+    void captureWorld(SimWorld &snapshot) const;
+
+    // 电脑对手的数量（共用同一个推演线程池）
+    int botCount() const;
+
+    // 模拟帧长（微秒），载入关卡时由 MatchSetup::tickHz 决定
+    int tickUs() const { return world.tickUs; }
+
+    // 暂停原因，可同时存在多个，全部解除后才继续
+    enum SuspendReason {
+        SUSPEND_HIDDEN = 1,     // 界面不可见：切换到其他界面或窗口最小化
+        SUSPEND_INACTIVE = 2,   // 窗口失去焦点（压力测试除外）
+        SUSPEND_PAUSED = 4      // 按 P 暂停
+    };
+
+    // 暂停时停止模拟线程、显示帧、电脑对手和自动存档，并松开所有按键；
+    // 继续时模拟从当前时刻重新计时，暂停的时长不计入对战时间
+    void setSuspended(SuspendReason reason, bool suspended);
+    bool isSuspended() const { return suspendReasons != 0; }
+
+    // 遥测日志（可为空，由调用方持有并保证比本界面存活更久），须在 loadLevel 之前设置
+    void setTelemetry(Telemetry *log);
+
+    // 窗口压力测试：逐步加压直到整帧耗时超出预算，结束时输出结果并发出 stressFinished
+    void startStress(const StressTest::Options &options);
+
+    // 背景、静态图层、装饰物，以及对战世界、控件表、粒子和动画等实体存储
+    void reportMemory(MemoryStats &stats) const override;
+
 protected:
     void keyPressEvent(QKeyEvent *event) override;
     void keyReleaseEvent(QKeyEvent *event) override;
     void resizeEvent(QResizeEvent *event) override;
     void paintEvent(QPaintEvent *event) override;
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+    void changeEvent(QEvent *event) override;
 
 signals:
-    void gameOver(int winner);  // 游戏结束信号，winner=1表示玩家1获胜，2表示玩家2获胜
+    void stressFinished();      // 压力测试结束
+    void gameOver(int winner);  // 游戏结束信号，winner 为获胜的玩家编号（组队时为队伍编号），SimWorld::DRAW 表示同时倒下
 
 private:
-    // 创建游戏平台
-    void createPlatforms();
-
-    // 生成道具
-    void spawnBandage();
-    void spawnMedkit();
-    void spawnAdrenaline();
-    void spawnKnife();
-    void spawnBall();
-    void spawnRifle();
-    void spawnSniper();
-    void spawnLightArmor(); // 新增：生成锁子甲
-    void spawnBulletproofVest(); // 新增：生成防弹衣
-
-    // 更新道具位置
-    void updateItems();
+    // 镜头跟随存活角色的中点，限制在关卡范围内；smoothing=1 时直接对准
+    void updateCamera(double smoothing, double alpha);
+
+    // 载入镜头附近的区块装饰物，卸载离开镜头的区块
+    void updateChunks();
+
+    // 静态图层：绘制一个区块的平台和装饰物；合成镜头内的背景和区块
+    QImage renderChunkLayer(int chunk) const;
+    void updateStaticLayer();
+    void invalidateStaticLayer();
+
+    // 镜头左边缘（关卡坐标）
+    int viewLeft() const { return qRound(cameraX); }
+
+    // 世界被整体替换后（载入关卡、读档）：清空区块和实体控件，对准镜头并重新同步
+    void resetViews();
+
+    // 水平范围是否在镜头内（含边距）
+    bool isOnScreen(int x, int w) const;
+
+    // 显示帧：取得模拟线程最新发布的一帧，然后插值绘制
+    void frameTick();
+
+    // 有新的模拟帧时接收：分发对战事件，按经过的帧数推进粒子和动画
+    void receiveFrame();
+
+    // 根据前后两帧世界状态同步角色、道具和投射物控件，alpha 为插值比例 [0, 1)
+    void syncViews(double alpha);
+
+    // 最近帧间隔的平均值、标准差和最大值（毫秒）
+    void frameTimeStats(double &meanMs, double &stdDevMs, double &maxMs) const;
+
+    // 按窗口宽度和人数确定血条宽度
+    void layoutHud();
 
     // 更新血条显示
     void updateHealthBar(int player, int health);
 
-    // 检查攻击碰撞
-    void checkAttack();
+    // 玩家颜色（组队时按队伍）
+    QColor playerColor(int index) const;
+
+    // 显示治疗特效
+    void showHealEffect(const SimCharacter& character, const QString& text);
 
-    // 检查游戏结束条件
-    void checkGameOver();
+    // 取出帧号不超过 to.tick 的对战事件：更新血条，为受击、回血、护甲损坏和拾取道具产生粒子
+    void dispatchEvents(const SimWorld& to);
 
-    // 检查道具拾取
-    void checkItemPickup(Character* character);
+    // 攻击特效的动画帧事件
+    void onEffectEvent(QWidget* effect, const QString& name);
 
-    // 显示治疗特效
-    void showHealEffect(Character* character, const QString& text);
-
-    Character *character1; // 玩家1角色
-    Character *character2; // 玩家2角色
-    QLabel *background = nullptr;
-    QTimer *platformDebugTimer; // 平台调试绘制定时器
-    QTimer *attackCheckTimer;   // 攻击检测定时器
-    QTimer *gameOverTimer;      // 游戏结束检测定时器
-    QTimer *bandageSpawnTimer;  // 绷带生成定时器
-    QTimer *medkitSpawnTimer;   // 急救包生成定时器
-    QTimer *adrenalineSpawnTimer; // 新增：肾上腺素生成定时器
-    QTimer *knifeSpawnTimer;    // 新增：小刀生成定时器
-    QTimer *ballSpawnTimer;     // 新增：实心球生成定时器
-    QTimer *rifleSpawnTimer;    // 新增：步枪生成定时器
-    QTimer *sniperSpawnTimer;   // 新增：狙击枪生成定时器
-    QTimer *lightArmorSpawnTimer; // 新增：锁子甲生成定时器
-    QTimer *bulletproofVestSpawnTimer; // 新增：防弹衣生成定时器
-    QTimer *itemUpdateTimer;    // 道具更新定时器
+    // 按键映射到玩家和输入位
+    bool mapKey(int key, int &player, InputBit &bit) const;
+
+    // 切换玩家2的电脑对手：关 -> 简单 -> 普通 -> 困难 -> 关
+    void cycleBot();
+
+    // 切换到下一个可用关卡（F6）
+    void cycleLevel();
+
+    // 把输入投递给模拟线程，由下一帧采样，measured 表示计入延迟统计
+    void feedInput(int player, InputBit bit, bool pressed, bool measured, int64_t timeUs);
+
+    // 绘制输入延迟直方图
+    void drawLatencyHistogram(QPainter &painter);
+
+    // 导出延迟样本和输入回放
+    void exportLatency();
+
+    // 把压力测试的目标数量交给模拟线程（补足实体），并补足攻击特效
+    void applyStressLoad();
+
+    // 绘制内存统计（F7）
+    void drawMemoryOverlay(QPainter &painter);
+
+    // 绘制静态图层每个图块的光栅化耗时（F5）
+    void drawTileStats(QPainter &painter);
+
+    // 切换光栅化线程数：1 -> 2 -> 4 … -> 全部核心 -> 1（F8）
+    void cycleRasterThreads();
+
+    MatchSetup setup;
+    QVector<Character*> characters; // 按玩家顺序
+    QTimer *frameTimer;         // 显示帧定时器
+    int frameIntervalMs = 1000 / DEFAULT_DISPLAY_RATE;
+    int suspendReasons = SUSPEND_HIDDEN;    // 构造时尚未显示
+    bool matchStarted = false;  // startMatch 之后才自动存档
+    QTimer *autosaveTimer;      // 自动存档定时器
+    qint64 lastSaveNs = 0;      // 最近一次存档（界面线程部分）/读档的耗时
+    qint64 lastLoadNs = 0;
+    std::atomic<bool> saveInFlight{false};  // 后台存档尚未写完
+    QThreadPool savePool;       // 存档写盘线程
+    Telemetry *telemetry = nullptr;
+    QElapsedTimer frameClock;   // 高精度时钟，决定模拟推进和插值比例
     QWidget *gameArea;          // 游戏区域容器
 
-    // 血条相关
-    QWidget *healthContainer1 = nullptr; // 玩家1血条容器
-    QLabel *healthBar1 = nullptr;        // 玩家1血条（红色）
-    QLabel *healthText1 = nullptr;       // 玩家1血量数值
-    QWidget *healthContainer2 = nullptr; // 玩家2血条容器
-    QLabel *healthBar2 = nullptr;        // 玩家2血条（红色）
-    QLabel *healthText2 = nullptr;       // 玩家2血量数值
+    // 模拟线程与正在显示的对战世界（模拟线程发布的最新一帧的副本）
+    SimulationThread simulation;
+    SimWorld world;
+    SimWorld previousWorld;     // 上一模拟帧的状态（插值用）
+    quint64 reportedDroppedEvents = 0;  // 已处理过的事件队列丢弃数
+    qint64 simTickNs = SimWorld::DEFAULT_TICK_US * 1000LL;
+    qint64 lastFrameNs = 0;
+    qint64 frameTimes[FRAME_HISTORY] = {};
+    int frameTimeCount = 0;
+    int frameTimeNext = 0;
+    bool gameOverEmitted = false;
+    uint64_t matchSeed = 0;     // 本局随机种子（回放用）
+
+    // 输入延迟统计
+    LatencyProbe latency;
+
+    // 按键绑定
+    struct KeyBinding {
+        int player;
+        InputBit bit;
+    };
+    QHash<int, KeyBinding> keyBindings;
+
+    // 血条相关（每名玩家一个）
+    struct PlayerHud {
+        QWidget *container;     // 血条容器
+        QLabel *bar;            // 血条（红色）
+        QLabel *text;           // 血量数值
+    };
+    QVector<PlayerHud> huds;
+    QWidget *topBar = nullptr;
+    int hudBarWidth = 200;
+
+    // 动画数据与所有动画实例（按模拟帧推进）
+    AnimationLibrary animations;
+    Animator animator;
+
+    // 粒子特效（覆盖在游戏区域上方）
+    ParticleSystem *particles;
+
+    // 道具与投射物控件（按 SimWorld 中的编号对应）
+    QHash<int, Item*> itemViews;
+    QHash<int, QWidget*> projectileViews;
 
-    // 平台列表
-    std::vector<Platform> platforms;
+    // 镜头位置（关卡坐标，只做水平滚动）
+    double cameraX = 0.0;
 
-    // 道具列表
-    QList<Item*> items;
+    // 静态图层：背景、平台和装饰物只在关卡或窗口尺寸改变时重新绘制。
+    // 每个已载入区块一张预乘透明度的图，与背景合成为窗口大小的不透明缓冲，
+    // 镜头不动时每帧只需拷贝一次缓冲。合成按屏幕图块分给多个线程并行完成
+    QPixmap backgroundSource;           // 原始背景图
+    QImage backgroundLayer;             // 缩放到窗口大小的背景
+    QHash<int, QImage> chunkLayers;     // 已载入区块（按区块编号）
+    QImage staticLayer;                 // 合成结果（后台缓冲）
+    int staticLayerLeft = -1;           // 合成时的镜头位置，-1表示需要重新合成
+    QPixmap decorationPixmaps[2];       // 装饰物图片（各区块共享）
+    TileRenderer rasterizer;
+    QVector<TileRenderer::Command> renderList;  // 合成用的绘制列表（每次合成前清空）
 
-    // 实心球投射物列表
-    QList<BallProjectile*> ballProjectiles;
+    // 电脑对手（按玩家顺序，键盘控制的玩家为空）和它们共用的推演线程池
+    QVector<BotController*> bots;
+    QThreadPool botPool;
 
-    // 子弹列表
-    QList<Bullet*> bullets;
+    // 压力测试（未启动时为空）
+    std::unique_ptr<StressTest::Ramp> stressRamp;
+    StressTest::Options stressOptions;
+    SimRng stressRng;
+    QVector<AttackEffect*> stressEffects; // 循环播放的攻击特效，多出的隐藏备用
+    std::atomic<int> stressTargets[StressTest::KIND_COUNT] = {}; // 由模拟线程在每帧之前补足
 
-    // 狙击枪子弹列表
-    QList<Bullet*> sniperBullets;
+    // 界面线程的帧内临时数据（候选列表、编号表等），每次接收模拟帧和每个显示帧结束时重置；
+    // 分别统计接收模拟帧和显示帧经过 arena 与全局堆的字节数
+    TickArena tickArena;
+    AllocationMeter tickAllocations;
+    AllocationMeter frameAllocations;
 
-    // 高台图片标签
-    QLabel *grassLabel = nullptr; // 左侧高台草地图片标签
-    QLabel *snowLabel = nullptr;  // 右侧高台雪堆图片标签
+    // 内存统计：叠加层每隔 MEMORY_REFRESH_MS 重新扫描一次
+    static constexpr int MEMORY_REFRESH_MS = 500;
+    QStringList memoryLines;
+    QElapsedTimer memoryRefresh;
 
     // 调试选项
     bool drawAttackRange = false; // 是否绘制攻击范围
+    bool showLatency = false;     // 是否显示输入延迟直方图
+    bool showFrameStats = false;  // 是否显示帧间隔统计
+    bool showMemory = false;      // 是否显示内存统计
 };
 
 #endif // GAME_SCREEN_H
@@ -0,0 +1,56 @@
+#include "HeapCounter.h"
+
+#ifdef HEAP_COUNTER
+#include <cstdlib>
+#include <new>
+
+namespace {
+thread_local uint64_t heapBytes = 0;
+thread_local uint64_t heapAllocations = 0;
+}
+
+// 替换全局 operator new/delete 以统计堆分配（数组版本默认转发到这里）。
+// 分配失败时按标准约定调用 new_handler 后重试，没有 new_handler 时抛出 bad_alloc
+void* operator new(std::size_t size) {
+    heapBytes += size;
+    heapAllocations++;
+    for (;;) {
+        if (void* p = std::malloc(size ? size : 1)) return p;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+bool HeapCounter::enabled() {
+    return true;
+}
+
+uint64_t HeapCounter::threadBytes() {
+    return heapBytes;
+}
+
+uint64_t HeapCounter::threadAllocations() {
+    return heapAllocations;
+}
+#else
+bool HeapCounter::enabled() {
+    return false;
+}
+
+uint64_t HeapCounter::threadBytes() {
+    return 0;
+}
+
+uint64_t HeapCounter::threadAllocations() {
+    return 0;
+}
+#endif
@@ -0,0 +1,15 @@
+#ifndef HEAP_COUNTER_H
+#define HEAP_COUNTER_H
+
+#include <cstdint>
+
+// 全局堆（operator new）的分配计数，按线程统计，用于和 TickArena 对比。
+// 只有定义 HEAP_COUNTER 构建（qmake CONFIG+=heap_counter）时才替换全局 operator new/delete，
+// 否则不计数，enabled() 返回 false
+namespace HeapCounter {
+bool enabled();
+uint64_t threadBytes();
+uint64_t threadAllocations();
+}
+
+#endif // HEAP_COUNTER_H
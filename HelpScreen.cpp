@@ -55,10 +55,22 @@ HelpScreen::HelpScreen(QWidget *parent) : QWidget(parent) {
         "← - 向左移动\n"
         "→ - 向右移动\n"
         "↓ - 下蹲/隐身\n"
-        "L - 攻击", contentWidget);
+        "L - 攻击\n"
+        "B - 电脑对手(关/简单/普通/困难)", contentWidget);
     player2Controls->setStyleSheet("font-size: 16px; color: yellow;");
     gridLayout->addWidget(player2Controls, 4, 0, Qt::AlignLeft);
 
+    QLabel *player3Label = new QLabel("玩家3 (小键盘，--humans 3):", contentWidget);
+    player3Label->setStyleSheet("font-size: 18px; font-weight: bold; color: red;");
+    gridLayout->addWidget(player3Label, 5, 0, Qt::AlignLeft);
+
+    QLabel *player3Controls = new QLabel(
+        "8 - 跳跃  4 - 向左  6 - 向右  5 - 下蹲  0 - 攻击\n"
+        "--players 2-8 设置人数，--teams N 分队，其余玩家由电脑控制\n"
+        "P - 暂停/继续（窗口失去焦点或最小化时自动暂停）", contentWidget);
+    player3Controls->setStyleSheet("font-size: 16px; color: yellow;");
+    gridLayout->addWidget(player3Controls, 6, 0, Qt::AlignLeft);
+
     // 道具说明
     QLabel *itemsTitle = new QLabel("道具介绍", contentWidget);
     itemsTitle->setStyleSheet("font-size: 24px; font-weight: bold; color: red;");
@@ -0,0 +1,165 @@
+#include "HitTest.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HIT_TEST_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+// 标量实现，也用于向量实现剩下的尾部
+void collideScalar(const HitTest::Boxes& boxes, const HitTest::Boxes& targets, std::size_t from,
+                   std::vector<HitTest::Hit>& hits) {
+    int targetCount = static_cast<int>(targets.size());
+    for (std::size_t i = from; i < boxes.size(); i++) {
+        uint32_t mask = 0;
+        for (int t = 0; t < targetCount; t++) {
+            if (boxes.left[i] < targets.right[t] && targets.left[t] < boxes.right[i] &&
+                boxes.top[i] < targets.bottom[t] && targets.top[t] < boxes.bottom[i]) {
+                mask |= 1u << t;
+            }
+        }
+        if (mask) hits.push_back({static_cast<int>(i), mask});
+    }
+}
+
+#ifdef HIT_TEST_X86
+// 每次比较 8 个包围盒：各目标的边界预先广播，比较结果与目标位相与后累积成每个包围盒的掩码
+__attribute__((target("avx2")))
+std::size_t collideAvx2(const HitTest::Boxes& boxes, const HitTest::Boxes& targets, std::vector<HitTest::Hit>& hits) {
+    int targetCount = static_cast<int>(targets.size());
+    __m256i targetLeft[HitTest::MAX_TARGETS], targetTop[HitTest::MAX_TARGETS];
+    __m256i targetRight[HitTest::MAX_TARGETS], targetBottom[HitTest::MAX_TARGETS];
+    for (int t = 0; t < targetCount; t++) {
+        targetLeft[t] = _mm256_set1_epi32(targets.left[t]);
+        targetTop[t] = _mm256_set1_epi32(targets.top[t]);
+        targetRight[t] = _mm256_set1_epi32(targets.right[t]);
+        targetBottom[t] = _mm256_set1_epi32(targets.bottom[t]);
+    }
+
+    const __m256i zero = _mm256_setzero_si256();
+    alignas(32) uint32_t masks[8];
+    std::size_t i = 0;
+    for (; i + 8 <= boxes.size(); i += 8) {
+        __m256i left = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(boxes.left.data() + i));
+        __m256i top = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(boxes.top.data() + i));
+        __m256i right = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(boxes.right.data() + i));
+        __m256i bottom = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(boxes.bottom.data() + i));
+        __m256i acc = zero;
+        for (int t = 0; t < targetCount; t++) {
+            __m256i x = _mm256_and_si256(_mm256_cmpgt_epi32(targetRight[t], left), _mm256_cmpgt_epi32(right, targetLeft[t]));
+            __m256i y = _mm256_and_si256(_mm256_cmpgt_epi32(targetBottom[t], top), _mm256_cmpgt_epi32(bottom, targetTop[t]));
+            acc = _mm256_or_si256(acc, _mm256_and_si256(_mm256_and_si256(x, y), _mm256_set1_epi32(static_cast<int>(1u << t))));
+        }
+        int any = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(acc, zero))) ^ 0xFF;
+        if (!any) continue;
+        _mm256_store_si256(reinterpret_cast<__m256i*>(masks), acc);
+        for (; any; any &= any - 1) {
+            int lane = __builtin_ctz(any);
+            hits.push_back({static_cast<int>(i + lane), masks[lane]});
+        }
+    }
+    return i;
+}
+#endif
+
+#if defined(HIT_TEST_X86) && defined(__SSE2__)
+// 每次比较 4 个包围盒，做法同 AVX2
+std::size_t collideSse2(const HitTest::Boxes& boxes, const HitTest::Boxes& targets, std::vector<HitTest::Hit>& hits) {
+    int targetCount = static_cast<int>(targets.size());
+    const __m128i zero = _mm_setzero_si128();
+    alignas(16) uint32_t masks[4];
+    std::size_t i = 0;
+    for (; i + 4 <= boxes.size(); i += 4) {
+        __m128i left = _mm_loadu_si128(reinterpret_cast<const __m128i*>(boxes.left.data() + i));
+        __m128i top = _mm_loadu_si128(reinterpret_cast<const __m128i*>(boxes.top.data() + i));
+        __m128i right = _mm_loadu_si128(reinterpret_cast<const __m128i*>(boxes.right.data() + i));
+        __m128i bottom = _mm_loadu_si128(reinterpret_cast<const __m128i*>(boxes.bottom.data() + i));
+        __m128i acc = zero;
+        for (int t = 0; t < targetCount; t++) {
+            __m128i x = _mm_and_si128(_mm_cmpgt_epi32(_mm_set1_epi32(targets.right[t]), left),
+                                      _mm_cmpgt_epi32(right, _mm_set1_epi32(targets.left[t])));
+            __m128i y = _mm_and_si128(_mm_cmpgt_epi32(_mm_set1_epi32(targets.bottom[t]), top),
+                                      _mm_cmpgt_epi32(bottom, _mm_set1_epi32(targets.top[t])));
+            acc = _mm_or_si128(acc, _mm_and_si128(_mm_and_si128(x, y), _mm_set1_epi32(static_cast<int>(1u << t))));
+        }
+        int any = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(acc, zero))) ^ 0xF;
+        if (!any) continue;
+        _mm_store_si128(reinterpret_cast<__m128i*>(masks), acc);
+        for (; any; any &= any - 1) {
+            int lane = __builtin_ctz(any);
+            hits.push_back({static_cast<int>(i + lane), masks[lane]});
+        }
+    }
+    return i;
+}
+#endif
+}
+
+void HitTest::Boxes::clear() {
+    left.clear();
+    top.clear();
+    right.clear();
+    bottom.clear();
+}
+
+void HitTest::Boxes::reserve(std::size_t count) {
+    left.reserve(count);
+    top.reserve(count);
+    right.reserve(count);
+    bottom.reserve(count);
+}
+
+void HitTest::Boxes::add(int x, int y, int width, int height) {
+    left.push_back(x);
+    top.push_back(y);
+    right.push_back(x + width);
+    bottom.push_back(y + height);
+}
+
+bool HitTest::supported(Kernel kernel) {
+    switch (kernel) {
+    case SCALAR:
+        return true;
+    case SSE2:
+#if defined(HIT_TEST_X86) && defined(__SSE2__)
+        return true;
+#else
+        return false;
+#endif
+    case AVX2:
+#ifdef HIT_TEST_X86
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+HitTest::Kernel HitTest::best() {
+    static const Kernel kernel = supported(AVX2) ? AVX2 : supported(SSE2) ? SSE2 : SCALAR;
+    return kernel;
+}
+
+const char* HitTest::kernelName(Kernel kernel) {
+    switch (kernel) {
+    case SSE2: return "sse2";
+    case AVX2: return "avx2";
+    default: return "scalar";
+    }
+}
+
+void HitTest::collide(const Boxes& boxes, const Boxes& targets, std::vector<Hit>& hits, Kernel kernel) {
+    hits.clear();
+    if (targets.size() == 0 || targets.size() > MAX_TARGETS) return;
+    if (!supported(kernel)) kernel = SCALAR;
+
+    std::size_t done = 0;
+#ifdef HIT_TEST_X86
+    if (kernel == AVX2) done = collideAvx2(boxes, targets, hits);
+#endif
+#if defined(HIT_TEST_X86) && defined(__SSE2__)
+    if (kernel == SSE2) done = collideSse2(boxes, targets, hits);
+#endif
+    collideScalar(boxes, targets, done, hits);
+}
@@ -0,0 +1,46 @@
+#ifndef HIT_TEST_H
+#define HIT_TEST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 批量矩形相交测试：投射物的包围盒按分量连续存放（SoA），与全部目标逐一比较，
+// 每个投射物得到一个命中目标的位掩码。x86 上运行时选择 AVX2（每次8个）或 SSE2（每次4个），
+// 其他平台使用标量实现；各实现的结果完全一致。不依赖Qt
+class HitTest {
+public:
+    static constexpr int MAX_TARGETS = 32;  // 目标数上限（掩码位数）
+
+    enum Kernel { SCALAR, SSE2, AVX2 };
+
+    // 包围盒集合，范围为 [left, right) x [top, bottom)
+    struct Boxes {
+        std::vector<int32_t> left;
+        std::vector<int32_t> top;
+        std::vector<int32_t> right;
+        std::vector<int32_t> bottom;
+
+        void clear();
+        void reserve(std::size_t count);
+        void add(int x, int y, int width, int height);
+        std::size_t size() const { return left.size(); }
+    };
+
+    // 命中：包围盒下标，以及它接触到的目标（第 t 位对应 targets 中的第 t 个）
+    struct Hit {
+        int index = 0;
+        uint32_t targets = 0;
+    };
+
+    // 测试 boxes 中的每个包围盒与 targets（不超过 MAX_TARGETS 个）是否相交，
+    // 接触到任一目标的按下标顺序写入 hits（先清空）
+    static void collide(const Boxes& boxes, const Boxes& targets, std::vector<Hit>& hits, Kernel kernel = best());
+
+    // 当前CPU支持的最快实现
+    static Kernel best();
+    static bool supported(Kernel kernel);
+    static const char* kernelName(Kernel kernel);
+};
+
+#endif // HIT_TEST_H
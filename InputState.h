@@ -0,0 +1,58 @@
+#ifndef INPUT_STATE_H
+#define INPUT_STATE_H
+
+#include <cstdint>
+
+// 一帧内采样得到的玩家输入（InputBit 组合）
+struct TickInput {
+    uint8_t held = 0;       // 采样时按住的键
+    uint8_t pressed = 0;    // 自上次采样以来按下过的键（按下后立即松开也会记录）
+    uint8_t released = 0;   // 自上次采样以来松开过的键
+};
+
+// 玩家输入状态：按键事件随时写入，模拟每帧采样一次，保证输入响应不受事件循环抖动影响
+class InputState {
+public:
+    // 按下/松开（键盘事件）
+    void press(uint8_t bits) {
+        pressLatch |= bits & ~current;
+        current |= bits;
+    }
+
+    void release(uint8_t bits) {
+        releaseLatch |= bits & current;
+        current &= ~bits;
+    }
+
+    // 直接设置整组按键（电脑对手和脚本使用）
+    void setHeld(uint8_t bits) {
+        press(bits & ~current);
+        release(current & ~bits);
+    }
+
+    // 每帧调用一次：返回当前按键和上次采样以来的边沿
+    TickInput sample() {
+        TickInput input;
+        input.held = current;
+        input.pressed = pressLatch;
+        input.released = releaseLatch;
+        pressLatch = 0;
+        releaseLatch = 0;
+        return input;
+    }
+
+    uint8_t held() const { return current; }
+
+    void clear() {
+        current = 0;
+        pressLatch = 0;
+        releaseLatch = 0;
+    }
+
+private:
+    uint8_t current = 0;
+    uint8_t pressLatch = 0;
+    uint8_t releaseLatch = 0;
+};
+
+#endif // INPUT_STATE_H
@@ -1,11 +1,16 @@
 #include "KnifeAttackEffect.h"
 #include <QPainter>
 
-KnifeAttackEffect::KnifeAttackEffect(QWidget *parent) : QWidget(parent) {
+KnifeAttackEffect::KnifeAttackEffect(Animator *animator, const AnimationLibrary *animations, QWidget *parent)
+    : QWidget(parent), animator(animator) {
     setAttribute(Qt::WA_TransparentForMouseEvents);
     setAttribute(Qt::WA_NoSystemBackground);
-    effectTimer = new QTimer(this);
-    connect(effectTimer, &QTimer::timeout, this, &KnifeAttackEffect::hideEffect);
+    clips[0] = animations->find("knife_slash_left");
+    clips[1] = animations->find("knife_slash_right");
+    animation = animator->create();
+    animator->player(animation).listener = [this](const std::string &name) {
+        emit animationEvent(QString::fromStdString(name));
+    };
 }
 
 void KnifeAttackEffect::startAttack(bool isRight, int characterX, int characterY, int characterWidth, int characterHeight) {
@@ -21,27 +26,46 @@ void KnifeAttackEffect::startAttack(bool isRight, int characterX, int characterY
     int offsetX;
     if (directionRight) {
         offsetX = characterWidth * 0.6;
-        knifePixmap = QPixmap(":/new/prefix1/res/daoguang2.png");
     } else {
         offsetX = -characterWidth * 1.1;
-        knifePixmap = QPixmap(":/new/prefix1/res/daoguang.png");
-    }
-
-    // 缩放图片
-    if (!knifePixmap.isNull()) {
-        knifePixmap = knifePixmap.scaled(effectWidth, effectHeight, Qt::KeepAspectRatio, Qt::SmoothTransformation);
     }
 
     int posX = characterX + offsetX;
     int posY = characterY + (characterHeight - effectHeight)/2 + 10;
     move(posX, posY);
 
-    // 启动动画定时器
-    effectTimer->start(200);
+    // 从头播放
+    shownFrame = nullptr;
+    animator->play(animation, clips[directionRight ? 1 : 0]);
+    syncAnimation();
     show();
     raise();
 }
 
+// 切换到新的一帧时载入对应图片
+void KnifeAttackEffect::syncAnimation() {
+    if (!visible) return;
+    const AnimationPlayer &player = animator->player(animation);
+    if (player.finished) {
+        visible = false;
+        hide();
+        return;
+    }
+
+    const AnimationFrame *frame = player.currentFrame();
+    if (frame == shownFrame) return;
+    shownFrame = frame;
+    knifePixmap = frame ? QPixmap(QString::fromStdString(frame->image)) : QPixmap();
+    if (!knifePixmap.isNull()) {
+        knifePixmap = knifePixmap.scaled(width(), height(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+    update();
+}
+
+void KnifeAttackEffect::reportMemory(MemoryStats &stats) const {
+    if (shownFrame) stats.addPixmap(QString::fromStdString(shownFrame->image), knifePixmap);
+}
+
 void KnifeAttackEffect::paintEvent(QPaintEvent *event) {
     Q_UNUSED(event);
     if (!visible || knifePixmap.isNull()) return;
@@ -50,9 +74,3 @@ void KnifeAttackEffect::paintEvent(QPaintEvent *event) {
     painter.setRenderHint(QPainter::SmoothPixmapTransform);
     painter.drawPixmap(0, 0, knifePixmap);
 }
-
-void KnifeAttackEffect::hideEffect() {
-    effectTimer->stop();
-    visible = false;
-    hide();
-}
@@ -3,29 +3,38 @@
 
 #include <QWidget>
 #include <QPixmap>
-#include <QTimer>
+#include "Animation.h"
+#include "MemoryStats.h"
 
-// 小刀攻击特效类
-class KnifeAttackEffect : public QWidget {
+// 小刀攻击特效类，显示时长来自动画数据
+class KnifeAttackEffect : public QWidget, public MemoryReporter {
     Q_OBJECT
 public:
-    KnifeAttackEffect(QWidget *parent = nullptr);
+    KnifeAttackEffect(Animator *animator, const AnimationLibrary *animations, QWidget *parent = nullptr);
 
     // 开始小刀攻击动画
     void startAttack(bool isRight, int characterX, int characterY, int characterWidth, int characterHeight);
 
+    // 根据动画进度刷新显示，播放完毕后隐藏（每次绘制前调用）
+    void syncAnimation();
+
     // 是否可见
     bool isVisible() const { return visible; }
 
+    void reportMemory(MemoryStats &stats) const override;
+
+signals:
+    void animationEvent(const QString &name); // 动画帧事件（如 impact）
+
 protected:
     void paintEvent(QPaintEvent *event) override;
 
-private slots:
-    void hideEffect();
-
 private:
     QPixmap knifePixmap;
-    QTimer *effectTimer;
+    Animator *animator;
+    Animator::Handle animation;
+    const AnimationClip *clips[2]; // 0=向左, 1=向右
+    const AnimationFrame *shownFrame = nullptr;
     bool visible = false;
     bool directionRight = true;
 };
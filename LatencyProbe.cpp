@@ -0,0 +1,192 @@
+#include "LatencyProbe.h"
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+int64_t LatencyProbe::nowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void LatencyProbe::markInput(int player, uint8_t bit, bool pressed, bool measured, int64_t timeUs) {
+    Event event;
+    event.player = player;
+    event.bit = bit;
+    event.pressed = pressed;
+    event.measured = measured;
+    event.inputUs = timeUs;
+    pending.push_back(event);
+}
+
+// 一帧的事件要么全部记入回放，要么都不记，回放不会停在半帧的输入上
+void LatencyProbe::markTick(int64_t tick, int64_t timeUs) {
+    bool record = !replayFull && replayCapacity > 0;
+    if (record && trace.size() + pending.size() > replayCapacity) {
+        replayFull = true;
+        record = false;
+    }
+    for (Event& event : pending) {
+        event.tick = tick;
+        event.tickUs = timeUs;
+        if (record) trace.push_back(event);
+        if (event.measured) consumed.push_back(event);
+    }
+    pending.clear();
+}
+
+void LatencyProbe::setReplayCapture(size_t capacity) {
+    replayCapacity = capacity;
+    replayFull = false;
+    std::vector<Event>().swap(trace);
+    trace.reserve(capacity);
+}
+
+void LatencyProbe::markPresent(int64_t timeUs) {
+    for (const Event& event : consumed) markPresent(event, timeUs);
+    consumed.clear();
+}
+
+void LatencyProbe::takeSampled(std::vector<Event>& events) {
+    events.swap(consumed);
+    consumed.clear();
+}
+
+void LatencyProbe::markPresent(const Event& event, int64_t timeUs) {
+    Sample sample;
+    sample.tick = event.tick;
+    sample.player = event.player;
+    sample.bit = event.bit;
+    sample.inputToTickUs = event.tickUs - event.inputUs;
+    sample.tickToPresentUs = timeUs - event.tickUs;
+    addSample(sample);
+}
+
+void LatencyProbe::addSample(const Sample& sample) {
+    int64_t total = sample.totalUs();
+    int bucket = static_cast<int>(total / BUCKET_US);
+    if (bucket < 0) bucket = 0;
+    if (bucket >= BUCKET_COUNT) bucket = BUCKET_COUNT - 1;
+    buckets[bucket]++;
+    totalCount++;
+    totalSumUs += total;
+    if (total > totalMaxUs) totalMaxUs = total;
+
+    if (recentSamples.size() < MAX_SAMPLES) {
+        recentSamples.push_back(sample);
+    } else {
+        recentSamples[nextSample] = sample;
+        nextSample = (nextSample + 1) % MAX_SAMPLES;
+    }
+}
+
+void LatencyProbe::clear() {
+    pending.clear();
+    consumed.clear();
+    trace.clear();
+    replayFull = false;
+    recentSamples.clear();
+    nextSample = 0;
+    for (int64_t& bucket : buckets) bucket = 0;
+    totalCount = 0;
+    totalSumUs = 0;
+    totalMaxUs = 0;
+}
+
+int64_t LatencyProbe::maxBucket() const {
+    int64_t result = 0;
+    for (int64_t bucket : buckets) {
+        if (bucket > result) result = bucket;
+    }
+    return result;
+}
+
+// 百分位数（按直方图估算，精度为一格）
+int64_t LatencyProbe::percentileUs(double fraction) const {
+    if (totalCount == 0) return 0;
+    int64_t target = static_cast<int64_t>(fraction * totalCount);
+    if (target >= totalCount) target = totalCount - 1;
+    int64_t cumulative = 0;
+    for (int i = 0; i < BUCKET_COUNT - 1; i++) {
+        cumulative += buckets[i];
+        if (cumulative > target) return static_cast<int64_t>(i + 1) * BUCKET_US;
+    }
+    return totalMaxUs;
+}
+
+bool LatencyProbe::writeCsv(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) return false;
+
+    out << "tick,player,input,input_to_tick_us,tick_to_present_us,total_us\n";
+    // 环形缓冲写满后从最旧的样本开始输出
+    for (size_t i = 0; i < recentSamples.size(); i++) {
+        const Sample& s = recentSamples[(nextSample + i) % recentSamples.size()];
+        out << s.tick << ',' << s.player << ',' << static_cast<int>(s.bit) << ','
+            << s.inputToTickUs << ',' << s.tickToPresentUs << ',' << s.totalUs() << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+// 回放格式：第一行为文件头，其后每行一个输入事件，
+// lead_us 为事件发生到被采样的时间，回放时据此还原采样前的等待
+bool LatencyProbe::writeReplay(const std::string& path, const ReplayHeader& header) const {
+    std::ofstream out(path);
+    if (!out) return false;
+
+    out << "seed,level,spawn_tick,players,teams";
+    for (int p = 1; p <= header.players; p++) out << ",p" << p << "_width,p" << p << "_height";
+    out << ",tick_us";
+    out << "\n" << header.seed << ',' << header.level << ',' << header.spawnTick
+        << ',' << header.players << ',' << header.teams;
+    for (int p = 0; p < header.players; p++) out << ',' << header.width[p] << ',' << header.height[p];
+    out << ',' << header.tickUs << "\n";
+
+    out << "tick,player,input,pressed,measured,lead_us\n";
+    for (const Event& e : trace) {
+        out << e.tick << ',' << e.player << ',' << static_cast<int>(e.bit) << ','
+            << (e.pressed ? 1 : 0) << ',' << (e.measured ? 1 : 0) << ',' << (e.tickUs - e.inputUs) << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+bool LatencyProbe::readReplay(const std::string& path, ReplayHeader& header, std::vector<Event>& events) {
+    std::ifstream in(path);
+    if (!in) return false;
+
+    std::string line;
+    if (!std::getline(in, line) || !std::getline(in, line)) return false;
+    std::istringstream headerLine(line);
+    char comma;
+    headerLine >> header.seed >> comma;
+    std::getline(headerLine, header.level, ',');
+    headerLine >> header.spawnTick >> comma >> header.players >> comma >> header.teams;
+    if (!headerLine || header.players < 1 || header.players > SimWorld::MAX_PLAYERS) return false;
+    for (int p = 0; p < header.players; p++) {
+        headerLine >> comma >> header.width[p] >> comma >> header.height[p];
+    }
+    if (!headerLine) return false;
+    int tickUs = 0;
+    if (headerLine >> comma >> tickUs) {
+        if (tickUs < 1000000 / SimWorld::MAX_TICK_HZ || tickUs > 1000000 / SimWorld::MIN_TICK_HZ) return false;
+        header.tickUs = tickUs;
+    }
+
+    std::getline(in, line); // 事件列名
+    events.clear();
+    while (std::getline(in, line)) {
+        if (line.empty() || line == "\r") continue;
+        std::istringstream row(line);
+        Event e;
+        int bit = 0, pressed = 0, measured = 0;
+        int64_t leadUs = 0;
+        row >> e.tick >> comma >> e.player >> comma >> bit >> comma >> pressed >> comma >> measured >> comma >> leadUs;
+        if (!row || e.player < 1 || e.player > header.players) return false;
+        e.bit = static_cast<uint8_t>(bit);
+        e.pressed = pressed != 0;
+        e.measured = measured != 0;
+        e.inputUs = -leadUs; // 相对采样时刻
+        e.tickUs = 0;
+        events.push_back(e);
+    }
+    return true;
+}
@@ -0,0 +1,109 @@
+#ifndef LATENCY_PROBE_H
+#define LATENCY_PROBE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Simulation.h"
+
+// 输入延迟探针：记录每个按键事件从键盘事件、被模拟帧采样到第一次绘制的时间。
+// 不依赖Qt，界面和无界面回放共用同一套计时和统计
+class LatencyProbe {
+public:
+    static constexpr int BUCKET_US = 1000;   // 直方图每格1毫秒
+    static constexpr int BUCKET_COUNT = 64;  // 最后一格统计所有超出范围的样本
+    static constexpr size_t MAX_SAMPLES = 1 << 16; // 保留的最近样本数
+    static constexpr size_t DEFAULT_REPLAY_CAPACITY = 1 << 17; // 回放记录的事件数（约4MB）
+
+    // 一个输入事件（同时作为回放记录）
+    struct Event {
+        int64_t tick = -1;        // 采样该事件的模拟帧
+        int player = 1;
+        uint8_t bit = 0;          // InputBit
+        bool pressed = false;
+        bool measured = false;    // 是否计入延迟统计（键盘按下）
+        int64_t inputUs = 0;      // 键盘事件时刻
+        int64_t tickUs = 0;       // 被采样时刻
+    };
+
+    // 一个完整的延迟样本
+    struct Sample {
+        int64_t tick = 0;
+        int player = 1;
+        uint8_t bit = 0;
+        int64_t inputToTickUs = 0;
+        int64_t tickToPresentUs = 0;
+        int64_t totalUs() const { return inputToTickUs + tickToPresentUs; }
+    };
+
+    // 回放文件头：重建同一局对战所需的参数
+    struct ReplayHeader {
+        uint64_t seed = 0;
+        std::string level = "classic";
+        int64_t spawnTick = -1;   // 开始生成道具的帧，-1表示未开始
+        int players = 2;
+        int teams = 0;
+        int tickUs = SimWorld::DEFAULT_TICK_US;  // 模拟帧长，旧文件没有该列时为默认值
+        int width[SimWorld::MAX_PLAYERS] = {64, 64, 64, 64, 64, 64, 64, 64};
+        int height[SimWorld::MAX_PLAYERS] = {96, 96, 96, 96, 96, 96, 96, 96};
+    };
+
+    // 单调时钟（微秒）
+    static int64_t nowUs();
+
+    // 键盘或电脑对手产生输入
+    void markInput(int player, uint8_t bit, bool pressed, bool measured, int64_t timeUs);
+
+    // 模拟帧采样了此前的全部输入
+    void markTick(int64_t tick, int64_t timeUs);
+
+    // 画面已更新：已被采样的输入完成一次测量
+    void markPresent(int64_t timeUs);
+
+    // 采样和绘制不在同一线程时：取出已采样的测量事件交给绘制线程，
+    // 由绘制线程的探针逐个完成测量
+    void takeSampled(std::vector<Event>& events);
+    void markPresent(const Event& event, int64_t timeUs);
+
+    // 回放记录：开启后才记录（capacity 为0时关闭），容量一次性分配，采样时不再分配内存。
+    // 记满后停止记录，已记录的前一段仍能完整回放
+    void setReplayCapture(size_t capacity);
+    bool replayTruncated() const { return replayFull; }
+
+    // 清空事件、统计和回放记录（回放容量保留）
+    void clear();
+
+    // 统计
+    int64_t count() const { return totalCount; }
+    const int64_t* histogram() const { return buckets; }
+    int64_t maxBucket() const;
+    int64_t percentileUs(double fraction) const;
+    int64_t meanUs() const { return totalCount > 0 ? totalSumUs / totalCount : 0; }
+    int64_t maxUs() const { return totalMaxUs; }
+    const std::vector<Sample>& samples() const { return recentSamples; }
+    const std::vector<Event>& replayTrace() const { return trace; }
+
+    // 导出每个样本（CSV）
+    bool writeCsv(const std::string& path) const;
+
+    // 导出/读取输入回放（已记录的输入事件）
+    bool writeReplay(const std::string& path, const ReplayHeader& header) const;
+    static bool readReplay(const std::string& path, ReplayHeader& header, std::vector<Event>& events);
+
+private:
+    void addSample(const Sample& sample);
+
+    std::vector<Event> pending;   // 尚未被采样的事件
+    std::vector<Event> consumed;  // 已采样、尚未绘制的事件
+    std::vector<Event> trace;     // 已采样事件（回放用），不超过 replayCapacity
+    size_t replayCapacity = 0;
+    bool replayFull = false;
+    std::vector<Sample> recentSamples;
+    size_t nextSample = 0;        // recentSamples 写满后循环覆盖的位置
+    int64_t buckets[BUCKET_COUNT] = {};
+    int64_t totalCount = 0;
+    int64_t totalSumUs = 0;
+    int64_t totalMaxUs = 0;
+};
+
+#endif // LATENCY_PROBE_H
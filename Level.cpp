@@ -0,0 +1,284 @@
+#include "Level.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <type_traits>
+
+// 二进制载入直接拷贝数组，要求内存布局与文件一致
+static_assert(std::is_trivially_copyable<Platform>::value && sizeof(Platform) == 5 * sizeof(int32_t), "Platform 布局与关卡文件不一致");
+static_assert(std::is_trivially_copyable<Decoration>::value && sizeof(Decoration) == 5 * sizeof(int32_t), "Decoration 布局与关卡文件不一致");
+static_assert(sizeof(LevelPoint) == 2 * sizeof(int32_t), "LevelPoint 布局与关卡文件不一致");
+static_assert(sizeof(Level::BinaryHeader) % 4 == 0, "关卡文件头需4字节对齐");
+
+namespace {
+// 默认道具生成间隔（毫秒）
+const int DEFAULT_ITEM_INTERVAL_MS[Level::ITEM_TYPE_COUNT] = {
+    20000, // 绷带
+    30000, // 急救包
+    60000, // 肾上腺素
+    45000, // 小刀
+    60000, // 实心球
+    70000, // 步枪
+    90000, // 狙击枪
+    55000, // 锁子甲
+    65000  // 防弹衣
+};
+
+std::mutex registryMutex;
+std::map<std::string, std::shared_ptr<const Level>> loadedLevels;
+std::vector<std::string> searchPaths = { "levels" };
+
+// 数组是否完整位于数据范围内
+bool inRange(uint32_t offset, uint32_t count, size_t elementSize, size_t total) {
+    return offset % 4 == 0 && offset <= total && count <= (total - offset) / elementSize;
+}
+
+template <typename T>
+void copyArray(std::vector<T>& out, const char* data, uint32_t offset, uint32_t count) {
+    out.resize(count);
+    if (count > 0) std::memcpy(out.data(), data + offset, count * sizeof(T));
+}
+}
+
+Level::Level() {
+    std::copy(DEFAULT_ITEM_INTERVAL_MS, DEFAULT_ITEM_INTERVAL_MS + ITEM_TYPE_COUNT, itemIntervalMs);
+    buildChunks();
+}
+
+std::shared_ptr<const Level> Level::classic() {
+    static std::shared_ptr<const Level> level = [] {
+        auto l = std::make_shared<Level>();
+        l->name = "classic";
+        l->width = 1200;
+        l->height = 800;
+        l->platforms.push_back(Platform(100, 450, 1000, 100, 0));
+        l->platforms.push_back(Platform(210, 280, 210, 1, 1));
+        l->platforms.push_back(Platform(775, 280, 210, 1, 2));
+        l->platforms.push_back(Platform(500, 100, 200, 1, 0));
+        l->decorations.push_back({210, 250, 210, 60, Decoration::GRASS});
+        l->decorations.push_back({775, 250, 210, 60, Decoration::SNOW});
+        l->playerSpawns.push_back({200, 450});
+        l->playerSpawns.push_back({900, 450});
+        l->respawnPoints.push_back({600, 100});
+        l->itemMinX = 100;
+        l->itemMaxX = 1000;
+        l->buildChunks();
+        return l;
+    }();
+    return level;
+}
+
+// 每屏沿用标准竞技场的布局，草地和冰面左右交替；地面贯通整个关卡
+std::shared_ptr<const Level> Level::wide(int screens) {
+    const int screenWidth = 1200;
+    screens = std::max(1, screens);
+
+    auto l = std::make_shared<Level>();
+    l->name = "wide";
+    l->width = screens * screenWidth;
+    l->height = 800;
+    l->platforms.push_back(Platform(100, 450, l->width - 200, 100, 0));
+    for (int s = 0; s < screens; s++) {
+        int ox = s * screenWidth;
+        bool swap = (s % 2) == 1;
+        l->platforms.push_back(Platform(ox + 210, 280, 210, 1, swap ? 2 : 1));
+        l->platforms.push_back(Platform(ox + 775, 280, 210, 1, swap ? 1 : 2));
+        l->platforms.push_back(Platform(ox + 500, 100, 200, 1, 0));
+        l->decorations.push_back({ox + 210, 250, 210, 60, swap ? Decoration::SNOW : Decoration::GRASS});
+        l->decorations.push_back({ox + 775, 250, 210, 60, swap ? Decoration::GRASS : Decoration::SNOW});
+        l->respawnPoints.push_back({ox + 600, 100});
+    }
+
+    // 双方从中间一屏出生
+    int mid = (screens / 2) * screenWidth;
+    l->playerSpawns.push_back({mid + 200, 450});
+    l->playerSpawns.push_back({mid + 900, 450});
+    l->itemMinX = 100;
+    l->itemMaxX = l->width - 200;
+    l->buildChunks();
+    return l;
+}
+
+std::shared_ptr<const Level> Level::byName(const std::string& levelName) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto cached = loadedLevels.find(levelName);
+    if (cached != loadedLevels.end()) return cached->second;
+
+    std::shared_ptr<const Level> level;
+    for (const std::string& directory : searchPaths) {
+        std::string path = directory + "/" + levelName + ".lvb";
+        if (std::ifstream(path).good()) {
+            level = loadFile(path);
+            if (level) break;
+        }
+    }
+    if (!level && levelName == "classic") level = classic();
+    if (!level && levelName == "wide") level = wide(5);
+    if (level) loadedLevels[levelName] = level;
+    return level;
+}
+
+std::vector<std::string> Level::availableNames() {
+    std::vector<std::string> names = { "classic", "wide" };
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const std::string& directory : searchPaths) {
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+            if (entry.path().extension() != ".lvb") continue;
+            std::string stem = entry.path().stem().string();
+            if (std::find(names.begin(), names.end(), stem) == names.end()) names.push_back(stem);
+        }
+    }
+    return names;
+}
+
+void Level::addSearchPath(const std::string& directory) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    if (std::find(searchPaths.begin(), searchPaths.end(), directory) == searchPaths.end()) {
+        searchPaths.insert(searchPaths.begin(), directory);
+    }
+}
+
+std::shared_ptr<const Level> Level::fromBinary(const char* data, size_t size, std::string* error) {
+    auto fail = [error](const char* message) -> std::shared_ptr<const Level> {
+        if (error) *error = message;
+        return nullptr;
+    };
+
+    BinaryHeader header;
+    if (size < sizeof(header)) return fail("文件过短");
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, BINARY_MAGIC, 4) != 0) return fail("不是关卡文件");
+    if (header.version != BINARY_VERSION) return fail("关卡文件版本不匹配");
+    if (header.byteOrder != 0x01020304u) return fail("字节序不匹配");
+    if (header.totalSize != size) return fail("文件长度不匹配");
+    if (header.chunkWidth != CHUNK_WIDTH) return fail("区块宽度不匹配，请重新编译关卡");
+    if (header.width <= 0 || header.height <= 0 || header.itemMinX >= header.itemMaxX) return fail("关卡尺寸无效");
+    if (header.spawnCount == 0) return fail("缺少出生点");
+
+    uint32_t chunkCount = header.chunkCount;
+    if (chunkCount != static_cast<uint32_t>(std::max(1, (header.width + CHUNK_WIDTH - 1) / CHUNK_WIDTH)) ||
+        !inRange(header.nameOffset, header.nameLength, 1, size) ||
+        !inRange(header.platformOffset, header.platformCount, sizeof(Platform), size) ||
+        !inRange(header.decorationOffset, header.decorationCount, sizeof(Decoration), size) ||
+        !inRange(header.spawnOffset, header.spawnCount, sizeof(LevelPoint), size) ||
+        !inRange(header.respawnOffset, header.respawnCount, sizeof(LevelPoint), size) ||
+        !inRange(header.chunkPlatformStartOffset, chunkCount + 1, sizeof(int32_t), size) ||
+        !inRange(header.chunkPlatformIndexOffset, header.chunkPlatformIndexCount, sizeof(int32_t), size) ||
+        !inRange(header.chunkDecorationStartOffset, chunkCount + 1, sizeof(int32_t), size) ||
+        !inRange(header.chunkDecorationIndexOffset, header.chunkDecorationIndexCount, sizeof(int32_t), size)) {
+        return fail("关卡数据越界");
+    }
+
+    auto level = std::make_shared<Level>();
+    level->name.assign(data + header.nameOffset, header.nameLength);
+    level->width = header.width;
+    level->height = header.height;
+    level->itemMinX = header.itemMinX;
+    level->itemMaxX = header.itemMaxX;
+    std::copy(header.itemIntervalMs, header.itemIntervalMs + ITEM_TYPE_COUNT, level->itemIntervalMs);
+    copyArray(level->platforms, data, header.platformOffset, header.platformCount);
+    copyArray(level->decorations, data, header.decorationOffset, header.decorationCount);
+    copyArray(level->playerSpawns, data, header.spawnOffset, header.spawnCount);
+    copyArray(level->respawnPoints, data, header.respawnOffset, header.respawnCount);
+    copyArray(level->chunkPlatformStart, data, header.chunkPlatformStartOffset, chunkCount + 1);
+    copyArray(level->chunkPlatformIndex, data, header.chunkPlatformIndexOffset, header.chunkPlatformIndexCount);
+    copyArray(level->chunkDecorationStart, data, header.chunkDecorationStartOffset, chunkCount + 1);
+    copyArray(level->chunkDecorationIndex, data, header.chunkDecorationIndexOffset, header.chunkDecorationIndexCount);
+
+    // 装饰物种类用作贴图下标，不能依赖编译器的检查
+    for (const Decoration& d : level->decorations) {
+        if (d.kind != Decoration::GRASS && d.kind != Decoration::SNOW) return fail("装饰物种类无效");
+    }
+
+    // 区块索引只检查边界，内容由编译器保证
+    auto validIndex = [](const std::vector<int>& start, const std::vector<int>& index, size_t elementCount) {
+        if (start.front() != 0 || start.back() != static_cast<int>(index.size())) return false;
+        if (!std::is_sorted(start.begin(), start.end())) return false;
+        for (int i : index) {
+            if (i < 0 || static_cast<size_t>(i) >= elementCount) return false;
+        }
+        return true;
+    };
+    if (!validIndex(level->chunkPlatformStart, level->chunkPlatformIndex, level->platforms.size()) ||
+        !validIndex(level->chunkDecorationStart, level->chunkDecorationIndex, level->decorations.size())) {
+        return fail("区块索引无效");
+    }
+    return level;
+}
+
+// 整个文件一次读入
+std::shared_ptr<const Level> Level::loadFile(const std::string& path, std::string* error) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        if (error) *error = "无法打开 " + path;
+        return nullptr;
+    }
+    std::vector<char> data(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    if (!in.read(data.data(), static_cast<std::streamsize>(data.size()))) {
+        if (error) *error = "无法读取 " + path;
+        return nullptr;
+    }
+    return fromBinary(data.data(), data.size(), error);
+}
+
+void Level::buildChunks() {
+    int count = std::max(1, (width + CHUNK_WIDTH - 1) / CHUNK_WIDTH);
+    chunkPlatformStart.assign(count + 1, 0);
+    chunkDecorationStart.assign(count + 1, 0);
+
+    // 先按区块分组，再拼接为压缩行格式
+    std::vector<std::vector<int>> platformLists(count), decorationLists(count);
+    for (int i = 0; i < static_cast<int>(platforms.size()); i++) {
+        const Platform& p = platforms[i];
+        int first = std::max(0, std::min(p.x / CHUNK_WIDTH, count - 1));
+        int last = std::max(0, std::min((p.x + p.width) / CHUNK_WIDTH, count - 1));
+        for (int c = first; c <= last; c++) platformLists[c].push_back(i);
+    }
+    for (int i = 0; i < static_cast<int>(decorations.size()); i++) {
+        int c = std::max(0, std::min(decorations[i].x / CHUNK_WIDTH, count - 1));
+        decorationLists[c].push_back(i);
+    }
+
+    chunkPlatformIndex.clear();
+    chunkDecorationIndex.clear();
+    for (int c = 0; c < count; c++) {
+        chunkPlatformIndex.insert(chunkPlatformIndex.end(), platformLists[c].begin(), platformLists[c].end());
+        chunkDecorationIndex.insert(chunkDecorationIndex.end(), decorationLists[c].begin(), decorationLists[c].end());
+        chunkPlatformStart[c + 1] = static_cast<int>(chunkPlatformIndex.size());
+        chunkDecorationStart[c + 1] = static_cast<int>(chunkDecorationIndex.size());
+    }
+}
+
+int Level::chunkAt(int x) const {
+    int chunk = x / CHUNK_WIDTH;
+    return std::max(0, std::min(chunk, chunkCount() - 1));
+}
+
+LevelPoint Level::respawnPointNear(int x) const {
+    if (respawnPoints.empty()) return {width / 2, 100};
+    LevelPoint best = respawnPoints.front();
+    for (const LevelPoint& p : respawnPoints) {
+        if (std::abs(p.x - x) < std::abs(best.x - x)) best = p;
+    }
+    return best;
+}
+
+const Platform* Level::raycast(int x0, int y0, int x1, int y1, double& t) const {
+    const Platform* nearest = nullptr;
+    forEachPlatform(std::min(x0, x1), std::max(x0, x1), [&](const Platform& p) {
+        double hit;
+        if (segmentIntersectsRect(x0, y0, x1 - x0, y1 - y0, p.x, p.y, p.width, p.height, hit) &&
+            (!nearest || hit < t)) {
+            nearest = &p;
+            t = hit;
+        }
+        return false;
+    });
+    return nearest;
+}
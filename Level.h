@@ -0,0 +1,149 @@
+#ifndef LEVEL_H
+#define LEVEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Platform.h"
+
+// 装饰物（草地、雪堆图片），只用于显示
+struct Decoration {
+    enum Kind : int32_t { GRASS, SNOW };
+    int x, y, width, height;
+    Kind kind;
+};
+
+// 坐标点（出生点、复活点）
+struct LevelPoint {
+    int x, y;
+};
+
+// 关卡：平台、装饰物、出生点和道具生成表，按固定宽度切分为区块。
+// 区块索引让碰撞检测和显示只访问附近的区块，开销与关卡总长度无关。
+// 关卡文件（levels/*.lvl）在构建时由 tools/levelc.py 编译为二进制（*.lvb），
+// 载入时整块读入后直接拷贝各数组，不做文本解析
+class Level {
+public:
+    static constexpr int CHUNK_WIDTH = 600;
+    static constexpr int ITEM_TYPE_COUNT = 9;      // 与 SimItem::TYPE_COUNT 一致
+
+    // 二进制格式（小端，所有字段4字节对齐）
+    static constexpr char BINARY_MAGIC[4] = {'L', 'V', 'B', '1'};
+    static constexpr uint32_t BINARY_VERSION = 1;
+
+    struct BinaryHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t byteOrder;                  // 0x01020304，检查字节序
+        uint32_t totalSize;
+        int32_t width, height;
+        int32_t itemMinX, itemMaxX;
+        int32_t itemIntervalMs[ITEM_TYPE_COUNT];
+        int32_t chunkWidth;
+        uint32_t nameOffset, nameLength;
+        uint32_t platformOffset, platformCount;
+        uint32_t decorationOffset, decorationCount;
+        uint32_t spawnOffset, spawnCount;
+        uint32_t respawnOffset, respawnCount;
+        uint32_t chunkCount;                 // 区块数
+        uint32_t chunkPlatformStartOffset;   // chunkCount+1 个起始下标
+        uint32_t chunkPlatformIndexOffset, chunkPlatformIndexCount;
+        uint32_t chunkDecorationStartOffset;
+        uint32_t chunkDecorationIndexOffset, chunkDecorationIndexCount;
+    };
+
+    // 区块内的下标列表
+    struct IndexRange {
+        const int* first;
+        const int* last;
+        const int* begin() const { return first; }
+        const int* end() const { return last; }
+        int size() const { return static_cast<int>(last - first); }
+        int operator[](int i) const { return first[i]; }
+    };
+
+    std::string name;
+    int width = 1200;
+    int height = 800;                  // 跌落超过该高度后复活
+    std::vector<Platform> platforms;
+    std::vector<Decoration> decorations;
+    std::vector<LevelPoint> playerSpawns;   // 玩家出生点（x为左边缘，y为脚底）
+    std::vector<LevelPoint> respawnPoints;  // 跌落后回到最近的复活点（角色左上角）
+    int itemMinX = 100;                // 道具生成的水平范围 [itemMinX, itemMaxX)
+    int itemMaxX = 1000;
+    int itemIntervalMs[ITEM_TYPE_COUNT]; // 各类道具的生成间隔（毫秒），0表示不生成
+
+    Level();
+
+    // 标准竞技场（一屏，内置，不依赖关卡文件）
+    static std::shared_ptr<const Level> classic();
+
+    // 多屏宽的竞技场（内置）
+    static std::shared_ptr<const Level> wide(int screens);
+
+    // 按名称获取关卡：优先载入搜索目录中的 <name>.lvb，其次为内置关卡；未知名称返回空。
+    // 载入过的关卡会缓存，可在多线程中调用
+    static std::shared_ptr<const Level> byName(const std::string& levelName);
+
+    // 可用关卡名（内置关卡和搜索目录中的 .lvb 文件）
+    static std::vector<std::string> availableNames();
+
+    // 增加关卡文件搜索目录
+    static void addSearchPath(const std::string& directory);
+
+    // 从编译好的二进制数据/文件载入，失败时返回空并写入 error
+    static std::shared_ptr<const Level> fromBinary(const char* data, size_t size, std::string* error = nullptr);
+    static std::shared_ptr<const Level> loadFile(const std::string& path, std::string* error = nullptr);
+
+    // 建立区块索引（修改平台或装饰物后调用）
+    void buildChunks();
+
+    int chunkCount() const { return static_cast<int>(chunkPlatformStart.size()) - 1; }
+    int chunkAt(int x) const;
+
+    // 离 x 最近的复活点
+    LevelPoint respawnPointNear(int x) const;
+
+    // 线段 (x0, y0)-(x1, y1) 最先碰到的平台，t 为碰撞处的线段参数（0~1）；没有碰到时返回空。
+    // 只检查线段水平范围内的区块
+    const Platform* raycast(int x0, int y0, int x1, int y1, double& t) const;
+
+    // 遍历与 [x0, x1] 水平范围相交的平台，每个平台只访问一次；fn 返回 true 时停止
+    template <typename Fn>
+    void forEachPlatform(int x0, int x1, Fn&& fn) const {
+        int first = chunkAt(x0);
+        int last = chunkAt(x1);
+        for (int c = first; c <= last; c++) {
+            for (int index : platformsInChunk(c)) {
+                const Platform& p = platforms[index];
+                // 跨多个区块的平台只在范围内的第一个区块处理
+                if (c != first && chunkAt(p.x) != c) continue;
+                if (p.x > x1 || p.x + p.width < x0) continue;
+                if (fn(p)) return;
+            }
+        }
+    }
+
+    // 区块内的平台下标
+    IndexRange platformsInChunk(int chunk) const {
+        const int* base = chunkPlatformIndex.data();
+        return { base + chunkPlatformStart[chunk], base + chunkPlatformStart[chunk + 1] };
+    }
+
+    // 区块内的装饰物下标（跨区块的装饰物只记录在起始区块）
+    IndexRange decorationsInChunk(int chunk) const {
+        const int* base = chunkDecorationIndex.data();
+        return { base + chunkDecorationStart[chunk], base + chunkDecorationStart[chunk + 1] };
+    }
+
+private:
+    // 区块索引（压缩行格式：第 c 个区块的下标为 index[start[c]..start[c+1])）
+    std::vector<int> chunkPlatformStart;
+    std::vector<int> chunkPlatformIndex;
+    std::vector<int> chunkDecorationStart;
+    std::vector<int> chunkDecorationIndex;
+};
+
+#endif // LEVEL_H
@@ -0,0 +1,154 @@
+#include "MatchSnapshot.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+static_assert(sizeof(MatchSnapshot::Header) % 8 == 0, "存档文件头需8字节对齐");
+static_assert(std::is_trivially_copyable<SimCharacter>::value && std::is_trivially_copyable<SimStats>::value &&
+              std::is_trivially_copyable<SimTracer>::value && std::is_trivially_copyable<SimItem>::value &&
+              std::is_trivially_copyable<SimProjectile>::value, "存档按内存布局保存，结构体须可直接复制");
+static_assert(sizeof(SimCharacter::Weapon) == sizeof(int) && sizeof(SimItem::Type) == sizeof(int) &&
+              sizeof(SimProjectile::Kind) == sizeof(int), "枚举字段按 int 读取检查");
+
+namespace {
+// 文件头之后各段的偏移
+constexpr std::size_t CHARACTERS_OFFSET = sizeof(MatchSnapshot::Header);
+constexpr std::size_t STATS_OFFSET = CHARACTERS_OFFSET + sizeof(SimCharacter) * SimWorld::MAX_PLAYERS;
+constexpr std::size_t TRACERS_OFFSET = STATS_OFFSET + sizeof(SimStats) * SimWorld::MAX_PLAYERS;
+constexpr std::size_t ITEMS_OFFSET = TRACERS_OFFSET + sizeof(SimTracer) * SimWorld::MAX_PLAYERS;
+
+std::size_t totalSize(std::size_t itemCount, std::size_t projectileCount) {
+    return ITEMS_OFFSET + itemCount * sizeof(SimItem) + projectileCount * sizeof(SimProjectile);
+}
+
+// 读取记录中的整数字段；枚举也按整数读取，越界的值不会被当作枚举使用
+int readInt(const char* record, std::size_t offset) {
+    int value;
+    std::memcpy(&value, record + offset, sizeof(value));
+    return value;
+}
+
+bool inRange(int value, int low, int high) {
+    return value >= low && value < high;
+}
+}
+
+std::size_t MatchSnapshot::size(const SimWorld& world) {
+    return totalSize(world.items.size(), world.projectiles.size());
+}
+
+void MatchSnapshot::write(const SimWorld& world, char* out) {
+    std::memcpy(out + CHARACTERS_OFFSET, world.characters, sizeof(world.characters));
+    std::memcpy(out + STATS_OFFSET, world.stats, sizeof(world.stats));
+    std::memcpy(out + TRACERS_OFFSET, world.tracers, sizeof(world.tracers));
+    char* items = out + ITEMS_OFFSET;
+    if (!world.items.empty()) std::memcpy(items, world.items.data(), world.items.size() * sizeof(SimItem));
+    char* projectiles = items + world.items.size() * sizeof(SimItem);
+    if (!world.projectiles.empty()) {
+        std::memcpy(projectiles, world.projectiles.data(), world.projectiles.size() * sizeof(SimProjectile));
+    }
+
+    Header header = {};
+    std::memcpy(header.magic, MAGIC, 4);
+    header.version = VERSION;
+    header.byteOrder = 0x01020304u;
+    header.totalSize = static_cast<uint32_t>(size(world));
+    header.characterSize = sizeof(SimCharacter);
+    header.statsSize = sizeof(SimStats);
+    header.tracerSize = sizeof(SimTracer);
+    header.itemSize = sizeof(SimItem);
+    header.projectileSize = sizeof(SimProjectile);
+    header.itemCount = static_cast<uint32_t>(world.items.size());
+    header.projectileCount = static_cast<uint32_t>(world.projectiles.size());
+    header.playerCount = world.playerCount;
+    header.tickUs = world.tickUs;
+    header.spawning = world.spawning ? 1 : 0;
+    header.nextEntityId = world.nextEntityId;
+    std::copy(world.spawnRemainingMs, world.spawnRemainingMs + SimItem::TYPE_COUNT, header.spawnRemainingMs);
+    std::copy(world.previousInput, world.previousInput + SimWorld::MAX_PLAYERS, header.previousInput);
+    std::strncpy(header.level, world.level->name.c_str(), LEVEL_NAME_SIZE - 1);
+    header.rngState = world.rng.state;
+    header.tick = world.tick;
+    header.elapsedUs = world.elapsedUs;
+    header.elapsedMs = world.elapsedMs;
+    std::memcpy(out, &header, sizeof(header));
+}
+
+bool MatchSnapshot::restore(const char* data, std::size_t size, SimWorld& world, std::string* error) {
+    auto fail = [error](const char* message) {
+        if (error) *error = message;
+        return false;
+    };
+
+    Header header;
+    if (size < sizeof(header)) return fail("文件过短");
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, 4) != 0) return fail("不是存档文件");
+    if (header.version != VERSION) return fail("存档版本不匹配");
+    if (header.byteOrder != 0x01020304u) return fail("字节序不匹配");
+    if (header.characterSize != sizeof(SimCharacter) || header.statsSize != sizeof(SimStats) ||
+        header.tracerSize != sizeof(SimTracer) || header.itemSize != sizeof(SimItem) ||
+        header.projectileSize != sizeof(SimProjectile)) {
+        return fail("存档数据布局不匹配");
+    }
+    if (header.totalSize != size || size != totalSize(header.itemCount, header.projectileCount)) {
+        return fail("文件长度不匹配");
+    }
+    if (header.playerCount < 1 || header.playerCount > SimWorld::MAX_PLAYERS) return fail("人数无效");
+    if (header.tickUs < 1000000 / SimWorld::MAX_TICK_HZ || header.tickUs > 1000000 / SimWorld::MIN_TICK_HZ) {
+        return fail("模拟频率无效");
+    }
+    header.level[LEVEL_NAME_SIZE - 1] = '\0';
+    std::shared_ptr<const Level> level = Level::byName(header.level);
+    if (!level) return fail("未知关卡");
+
+    // 会被用作数组下标的字段：损坏或被改过的存档在写入世界之前拒绝
+    for (int i = 0; i < SimWorld::MAX_PLAYERS; i++) {
+        const char* c = data + CHARACTERS_OFFSET + i * sizeof(SimCharacter);
+        if (!inRange(readInt(c, offsetof(SimCharacter, weapon)), 0, SimCharacter::WEAPON_COUNT) ||
+            !inRange(readInt(c, offsetof(SimCharacter, team)), 0, SimWorld::MAX_PLAYERS) ||
+            !inRange(readInt(c, offsetof(SimCharacter, health)), 0, 101)) {
+            return fail("角色数据无效");
+        }
+    }
+    const char* items = data + ITEMS_OFFSET;
+    for (uint32_t i = 0; i < header.itemCount; i++) {
+        if (!inRange(readInt(items + i * sizeof(SimItem), offsetof(SimItem, type)), 0, SimItem::TYPE_COUNT)) {
+            return fail("道具数据无效");
+        }
+    }
+    const char* projectiles = items + header.itemCount * sizeof(SimItem);
+    for (uint32_t i = 0; i < header.projectileCount; i++) {
+        const char* p = projectiles + i * sizeof(SimProjectile);
+        int kind = readInt(p, offsetof(SimProjectile, kind));
+        if ((kind != SimProjectile::BALL && kind != SimProjectile::BULLET) ||
+            !inRange(readInt(p, offsetof(SimProjectile, owner)), 0, header.playerCount)) {
+            return fail("投射物数据无效");
+        }
+    }
+
+    world.level = level;
+    world.playerCount = header.playerCount;
+    world.tickUs = header.tickUs;
+    world.spawning = header.spawning != 0;
+    world.nextEntityId = header.nextEntityId;
+    std::copy(header.spawnRemainingMs, header.spawnRemainingMs + SimItem::TYPE_COUNT, world.spawnRemainingMs);
+    std::copy(header.previousInput, header.previousInput + SimWorld::MAX_PLAYERS, world.previousInput);
+    world.rng.state = header.rngState;
+    world.tick = header.tick;
+    world.elapsedUs = header.elapsedUs;
+    world.elapsedMs = header.elapsedMs;
+    world.events.clear();
+
+    std::memcpy(world.characters, data + CHARACTERS_OFFSET, sizeof(world.characters));
+    std::memcpy(world.stats, data + STATS_OFFSET, sizeof(world.stats));
+    std::memcpy(world.tracers, data + TRACERS_OFFSET, sizeof(world.tracers));
+    world.items.resize(header.itemCount);
+    if (header.itemCount > 0) std::memcpy(world.items.data(), items, header.itemCount * sizeof(SimItem));
+    world.projectiles.resize(header.projectileCount);
+    if (header.projectileCount > 0) {
+        std::memcpy(world.projectiles.data(), projectiles, header.projectileCount * sizeof(SimProjectile));
+    }
+    return true;
+}
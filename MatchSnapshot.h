@@ -0,0 +1,55 @@
+#ifndef MATCH_SNAPSHOT_H
+#define MATCH_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "Simulation.h"
+
+// 对战存档：整个 SimWorld 按固定布局写成二进制，读取时直接从映射到内存的文件恢复。
+// 布局：文件头 | 角色 x MAX_PLAYERS | 统计 x MAX_PLAYERS | 弹道 x MAX_PLAYERS | 道具 | 投射物。
+// 结构体按内存布局原样保存，文件头记录各结构体的大小，布局变化后旧存档会被拒绝。
+// 关卡只保存名称，恢复时按名称重新获取。不依赖Qt
+class MatchSnapshot {
+public:
+    static constexpr char MAGIC[4] = {'S', 'N', 'P', '1'};
+    static constexpr uint32_t VERSION = 1;
+    static constexpr int LEVEL_NAME_SIZE = 32;
+
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint32_t byteOrder;                 // 0x01020304，检查字节序
+        uint32_t totalSize;
+        uint32_t characterSize;             // 各结构体的大小
+        uint32_t statsSize;
+        uint32_t tracerSize;
+        uint32_t itemSize;
+        uint32_t projectileSize;
+        uint32_t itemCount;
+        uint32_t projectileCount;
+        int32_t playerCount;
+        int32_t tickUs;
+        int32_t spawning;
+        int32_t nextEntityId;
+        int32_t spawnRemainingMs[SimItem::TYPE_COUNT];
+        uint8_t previousInput[SimWorld::MAX_PLAYERS];
+        char level[LEVEL_NAME_SIZE];        // 关卡名，以0结尾
+        uint64_t rngState;
+        int64_t tick;
+        int64_t elapsedUs;
+        int64_t elapsedMs;
+    };
+
+    // 存档大小（字节）
+    static std::size_t size(const SimWorld& world);
+
+    // 写入 out（至少 size(world) 字节）。不处理文件：调用方负责整体替换旧存档
+    static void write(const SimWorld& world, char* out);
+
+    // 校验文件头和记录中用作下标的字段（武器、队伍、生命、道具类型、投射物发射者）后
+    // 恢复到 world（保留 world 的内存来源）；失败时 world 不变并写入 error
+    static bool restore(const char* data, std::size_t size, SimWorld& world, std::string* error = nullptr);
+};
+
+#endif // MATCH_SNAPSHOT_H
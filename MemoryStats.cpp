@@ -0,0 +1,205 @@
+#include "MemoryStats.h"
+#include <QApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTimer>
+#include <algorithm>
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+namespace {
+QString formatBytes(qint64 bytes) {
+    if (bytes >= 1024 * 1024) return QString("%1 MB").arg(bytes / (1024.0 * 1024.0), 0, 'f', 1);
+    if (bytes >= 1024) return QString("%1 KB").arg(bytes / 1024.0, 0, 'f', 1);
+    return QString("%1 B").arg(bytes);
+}
+}
+
+MemoryStats MemoryStats::collect() {
+    MemoryStats stats;
+    stats.timestampMs = QDateTime::currentMSecsSinceEpoch();
+    stats.rssBytes = readResidentBytes();
+
+    const QList<QWidget*> allWidgets = QApplication::allWidgets();
+    for (QWidget *widget : allWidgets) {
+        ClassCount &count = stats.widgets[widget->metaObject()->className()];
+        count.live++;
+        if (widget->isHidden()) count.hidden++;
+
+        const MemoryReporter *reporter = dynamic_cast<const MemoryReporter*>(widget);
+        if (reporter) reporter->reportMemory(stats);
+
+        // 定时器都挂在某个控件下（顶层控件负责扫描整棵树）
+        if (widget->isWindow()) {
+            const QList<QTimer*> timers = widget->findChildren<QTimer*>();
+            for (QTimer *timer : timers) {
+                QObject *owner = timer->parent();
+                ClassCount &timerCount = stats.timers[owner ? owner->metaObject()->className() : "QTimer"];
+                timerCount.live++;
+                if (!timer->isActive()) timerCount.hidden++;
+            }
+        }
+    }
+    return stats;
+}
+
+void MemoryStats::addPixmap(const QString &path, const QPixmap &pixmap) {
+    if (pixmap.isNull()) return;
+    addPicture(path, seenPixmaps, pixmap.cacheKey(), pixmap.width(), pixmap.height(), pixmap.depth());
+}
+
+void MemoryStats::addImage(const QString &path, const QImage &image) {
+    if (image.isNull()) return;
+    addPicture(path, seenImages, image.cacheKey(), image.width(), image.height(), image.depth());
+}
+
+void MemoryStats::addPicture(const QString &path, QSet<qint64> &seen, qint64 cacheKey, int width, int height, int depth) {
+    PixmapAsset &asset = assets[path];
+    PixmapVariant &variant = asset.variants[QString("%1x%2").arg(width).arg(height)];
+    variant.references++;
+    if (seen.contains(cacheKey)) return;
+    seen.insert(cacheKey);
+
+    qint64 bytes = static_cast<qint64>(width) * height * depth / 8;
+    variant.copies++;
+    variant.bytes = bytes;
+    asset.bytes += bytes;
+    if (variant.copies > 1) asset.duplicateBytes += bytes;
+    totalPixmapBytes += bytes;
+}
+
+void MemoryStats::addStore(const QString &name, qint64 used, qint64 capacity, qint64 elementBytes) {
+    Store &store = stores[name];
+    store.used += used;
+    store.capacity += capacity;
+    store.elementBytes = elementBytes;
+}
+
+QStringList MemoryStats::assetsByBytes() const {
+    QStringList paths = assets.keys();
+    std::sort(paths.begin(), paths.end(), [this](const QString &a, const QString &b) {
+        return assets.value(a).bytes > assets.value(b).bytes;
+    });
+    return paths;
+}
+
+QByteArray MemoryStats::toJson() const {
+    QJsonObject root;
+    root["time_ms"] = timestampMs;
+    root["rss_bytes"] = rssBytes;
+    root["pixmap_bytes"] = totalPixmapBytes;
+
+    QJsonArray pixmapArray;
+    for (const QString &path : assetsByBytes()) {
+        const PixmapAsset &asset = assets.value(path);
+        QJsonArray variantArray;
+        for (auto it = asset.variants.constBegin(); it != asset.variants.constEnd(); ++it) {
+            QJsonObject variant;
+            variant["size"] = it.key();
+            variant["copies"] = it.value().copies;
+            variant["references"] = it.value().references;
+            variant["bytes_each"] = it.value().bytes;
+            variantArray.append(variant);
+        }
+        QJsonObject entry;
+        entry["path"] = path;
+        entry["bytes"] = asset.bytes;
+        entry["duplicate_bytes"] = asset.duplicateBytes;
+        entry["variants"] = variantArray;
+        pixmapArray.append(entry);
+    }
+    root["pixmaps"] = pixmapArray;
+
+    QJsonArray widgetArray;
+    for (auto it = widgets.constBegin(); it != widgets.constEnd(); ++it) {
+        QJsonObject entry;
+        entry["class"] = it.key();
+        entry["live"] = it.value().live;
+        entry["hidden"] = it.value().hidden;
+        widgetArray.append(entry);
+    }
+    root["widgets"] = widgetArray;
+
+    QJsonArray timerArray;
+    for (auto it = timers.constBegin(); it != timers.constEnd(); ++it) {
+        QJsonObject entry;
+        entry["owner"] = it.key();
+        entry["live"] = it.value().live;
+        entry["stopped"] = it.value().hidden;
+        timerArray.append(entry);
+    }
+    root["timers"] = timerArray;
+
+    QJsonArray storeArray;
+    for (auto it = stores.constBegin(); it != stores.constEnd(); ++it) {
+        QJsonObject entry;
+        entry["name"] = it.key();
+        entry["used"] = it.value().used;
+        entry["capacity"] = it.value().capacity;
+        entry["element_bytes"] = it.value().elementBytes;
+        storeArray.append(entry);
+    }
+    root["stores"] = storeArray;
+
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+bool MemoryStats::appendTo(const QString &path) const {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) return false;
+    QByteArray line = toJson();
+    line.append('\n');
+    return file.write(line) == line.size();
+}
+
+QStringList MemoryStats::overlayLines() const {
+    QStringList lines;
+    lines << QString("内存  常驻 %1  图片 %2")
+                 .arg(rssBytes > 0 ? formatBytes(rssBytes) : QString("未知"))
+                 .arg(formatBytes(totalPixmapBytes));
+
+    // 图片只列出占用最多的几项
+    const int maxAssets = 8;
+    QStringList paths = assetsByBytes();
+    for (int i = 0; i < paths.size() && i < maxAssets; i++) {
+        const PixmapAsset &asset = assets.value(paths[i]);
+        int copies = 0;
+        for (const PixmapVariant &variant : asset.variants) copies += variant.copies;
+        QString line = QString("  %1  %2 张  %3").arg(paths[i].section('/', -1)).arg(copies).arg(formatBytes(asset.bytes));
+        if (asset.duplicateBytes > 0) line += QString("（重复 %1）").arg(formatBytes(asset.duplicateBytes));
+        lines << line;
+    }
+    if (paths.size() > maxAssets) lines << QString("  …另有 %1 项").arg(paths.size() - maxAssets);
+
+    lines << "控件（存活/隐藏）";
+    for (auto it = widgets.constBegin(); it != widgets.constEnd(); ++it) {
+        lines << QString("  %1  %2/%3").arg(it.key()).arg(it.value().live).arg(it.value().hidden);
+    }
+    lines << "定时器（所属类：存活/停止）";
+    for (auto it = timers.constBegin(); it != timers.constEnd(); ++it) {
+        lines << QString("  %1  %2/%3").arg(it.key()).arg(it.value().live).arg(it.value().hidden);
+    }
+    lines << "实体存储（已用/容量）";
+    for (auto it = stores.constBegin(); it != stores.constEnd(); ++it) {
+        lines << QString("  %1  %2/%3  %4").arg(it.key()).arg(it.value().used).arg(it.value().capacity)
+                     .arg(formatBytes(it.value().capacity * it.value().elementBytes));
+    }
+    return lines;
+}
+
+// 进程常驻内存，目前只支持 Linux，其他平台返回0
+qint64 MemoryStats::readResidentBytes() {
+#ifdef Q_OS_LINUX
+    QFile file("/proc/self/statm");
+    if (!file.open(QIODevice::ReadOnly)) return 0;
+    QList<QByteArray> fields = file.readAll().split(' ');
+    if (fields.size() < 2) return 0;
+    return fields[1].toLongLong() * sysconf(_SC_PAGESIZE);
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,91 @@
+#ifndef MEMORY_STATS_H
+#define MEMORY_STATS_H
+
+#include <QImage>
+#include <QPixmap>
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QMap>
+#include <QSet>
+#include <QSize>
+#include <QWidget>
+
+class MemoryStats;
+
+// 持有图片或实体存储的对象实现此接口，由 MemoryStats::collect 扫描时调用
+class MemoryReporter {
+public:
+    virtual ~MemoryReporter() {}
+    virtual void reportMemory(MemoryStats &stats) const = 0;
+};
+
+// 内存统计快照：按资源路径统计已解码的图片（含重复缩放的副本）、
+// 按类统计存活的控件和定时器，以及各实体存储的用量与容量。
+// 同一张图片（cacheKey 相同）无论被多少对象引用只计一次
+class MemoryStats {
+public:
+    // 扫描所有控件和定时器，并收集实现了 MemoryReporter 的控件上报的图片和存储
+    static MemoryStats collect();
+
+    // 上报一张图片，path 为资源路径（生成的图片用 <名称> 表示）
+    void addPixmap(const QString &path, const QPixmap &pixmap);
+    void addImage(const QString &path, const QImage &image);
+
+    // 上报一个实体存储：已用元素数、已分配容量、每个元素的字节数
+    void addStore(const QString &name, qint64 used, qint64 capacity, qint64 elementBytes);
+
+    // 单行 JSON（定期转储时每次追加一行）
+    QByteArray toJson() const;
+
+    // 把 toJson 的结果追加为文件的一行
+    bool appendTo(const QString &path) const;
+
+    // 调试叠加层显示的文字
+    QStringList overlayLines() const;
+
+    qint64 pixmapBytes() const { return totalPixmapBytes; }
+    qint64 residentBytes() const { return rssBytes; }
+
+private:
+    // 同一资源路径、同一尺寸的图片
+    struct PixmapVariant {
+        int copies = 0;         // 不同的图片数（多于1张即为重复缩放）
+        int references = 0;     // 引用次数
+        qint64 bytes = 0;       // 单张字节数
+    };
+    struct PixmapAsset {
+        QMap<QString, PixmapVariant> variants; // 按 "宽x高" 索引
+        qint64 bytes = 0;
+        qint64 duplicateBytes = 0;  // 同尺寸多余副本占用的字节
+    };
+    struct ClassCount {
+        int live = 0;
+        int hidden = 0;         // 控件：已隐藏；定时器：未运行
+    };
+    struct Store {
+        qint64 used = 0;
+        qint64 capacity = 0;
+        qint64 elementBytes = 0;
+    };
+
+    // 计入一张图片：seen 为对应类型已计入的 cacheKey（QPixmap 与 QImage 的 cacheKey 各自编号）
+    void addPicture(const QString &path, QSet<qint64> &seen, qint64 cacheKey, int width, int height, int depth);
+
+    // 按占用字节从大到小排列的资源路径
+    QStringList assetsByBytes() const;
+
+    static qint64 readResidentBytes();
+
+    QMap<QString, PixmapAsset> assets;
+    QSet<qint64> seenPixmaps;           // 已计入的 cacheKey
+    QSet<qint64> seenImages;
+    QMap<QString, ClassCount> widgets;  // 按类名
+    QMap<QString, ClassCount> timers;   // 按所属对象的类名
+    QMap<QString, Store> stores;
+    qint64 totalPixmapBytes = 0;
+    qint64 rssBytes = 0;
+    qint64 timestampMs = 0;
+};
+
+#endif // MEMORY_STATS_H
@@ -0,0 +1,149 @@
+#include "ParticleSystem.h"
+#include <QPainter>
+#include <QFont>
+
+namespace {
+// 各种粒子的参数
+struct KindParams {
+    int speed;      // 初速度上限（像素/秒）
+    int gravity;    // 像素/秒²，负数表示上浮
+    int lifeMs;
+    int size;
+    QColor color;
+};
+
+const KindParams KIND_PARAMS[ParticleSystem::KIND_COUNT] = {
+    { 260,  900, 280, 3, QColor(255, 200, 60) },   // 受击火花
+    {  50, -120, 700, 4, QColor(80, 230, 120) },   // 回血
+    { 200, 1200, 600, 5, QColor(170, 170, 180) },  // 护甲碎片
+    {  80,    0, 400, 3, QColor(255, 255, 220) }   // 拾取闪光
+};
+
+const int TEXT_LIFE_MS = 800;
+const int TEXT_RISE_SPEED = 40; // 像素/秒
+}
+
+ParticleSystem::ParticleSystem(QWidget *parent) : QWidget(parent), rng(0x5EED) {
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+}
+
+int ParticleSystem::spawn(Kind kind, int x, int y, int count) {
+    int allowed = qMin(count, qMin(FRAME_BUDGET - frameSpawned, CAPACITY - particleCount));
+    allowed = qMax(0, allowed);
+    droppedTotal += count - allowed;
+    frameSpawned += allowed;
+
+    const KindParams& params = KIND_PARAMS[kind];
+    for (int n = 0; n < allowed; n++) {
+        int i = particleCount++;
+        posX[i] = static_cast<float>(x + rng.bounded(-6, 7));
+        posY[i] = static_cast<float>(y + rng.bounded(-6, 7));
+        velX[i] = static_cast<float>(rng.bounded(-params.speed, params.speed + 1));
+        velY[i] = static_cast<float>(rng.bounded(-params.speed, params.speed / 2 + 1));
+        ageMs[i] = 0;
+        lifeMs[i] = static_cast<int16_t>(params.lifeMs / 2 + rng.bounded(0, params.lifeMs / 2 + 1));
+        kinds[i] = static_cast<uint8_t>(kind);
+    }
+    return allowed;
+}
+
+void ParticleSystem::spawnText(const QString &text, int x, int y, const QColor &color) {
+    if (texts.size() >= MAX_TEXTS) texts.removeFirst();
+    FloatingText t;
+    t.text = text;
+    t.color = color;
+    t.x = static_cast<float>(x);
+    t.y = static_cast<float>(y);
+    texts.append(t);
+}
+
+// 交换删除：把最后一个粒子移到空位，存活粒子保持连续
+void ParticleSystem::removeAt(int index) {
+    int last = --particleCount;
+    posX[index] = posX[last];
+    posY[index] = posY[last];
+    velX[index] = velX[last];
+    velY[index] = velY[last];
+    ageMs[index] = ageMs[last];
+    lifeMs[index] = lifeMs[last];
+    kinds[index] = kinds[last];
+}
+
+void ParticleSystem::step(int ms) {
+    float dt = ms / 1000.0f;
+    for (int i = 0; i < particleCount;) {
+        ageMs[i] = static_cast<int16_t>(ageMs[i] + ms);
+        if (ageMs[i] >= lifeMs[i]) {
+            removeAt(i);
+            continue;
+        }
+        velY[i] += KIND_PARAMS[kinds[i]].gravity * dt;
+        posX[i] += velX[i] * dt;
+        posY[i] += velY[i] * dt;
+        i++;
+    }
+
+    for (int i = 0; i < texts.size();) {
+        FloatingText& t = texts[i];
+        t.ageMs += ms;
+        if (t.ageMs >= TEXT_LIFE_MS) {
+            texts.removeAt(i);
+            continue;
+        }
+        t.y -= TEXT_RISE_SPEED * dt;
+        i++;
+    }
+    if (particleCount > 0 || !texts.isEmpty()) update();
+}
+
+void ParticleSystem::setCameraLeft(int left) {
+    if (left == cameraLeft) return;
+    cameraLeft = left;
+    if (particleCount > 0 || !texts.isEmpty()) update();
+}
+
+void ParticleSystem::clear() {
+    particleCount = 0;
+    texts.clear();
+    update();
+}
+
+// 按种类和淡出程度分组，每组一次提交
+void ParticleSystem::paintEvent(QPaintEvent *) {
+    if (particleCount == 0 && texts.isEmpty()) return;
+
+    for (auto& kindBatches : batches) {
+        for (std::vector<QRectF>& batch : kindBatches) batch.clear();
+    }
+    for (int i = 0; i < particleCount; i++) {
+        int fade = (lifeMs[i] - ageMs[i]) * FADE_LEVELS / lifeMs[i];
+        fade = qBound(0, fade, FADE_LEVELS - 1);
+        float size = static_cast<float>(KIND_PARAMS[kinds[i]].size);
+        batches[kinds[i]][fade].emplace_back(posX[i] - cameraLeft - size / 2, posY[i] - size / 2, size, size);
+    }
+
+    QPainter painter(this);
+    painter.setPen(Qt::NoPen);
+    for (int kind = 0; kind < KIND_COUNT; kind++) {
+        for (int fade = 0; fade < FADE_LEVELS; fade++) {
+            const std::vector<QRectF>& batch = batches[kind][fade];
+            if (batch.empty()) continue;
+            QColor color = KIND_PARAMS[kind].color;
+            color.setAlpha(255 * (fade + 1) / FADE_LEVELS);
+            painter.setBrush(color);
+            painter.drawRects(batch.data(), static_cast<int>(batch.size()));
+        }
+    }
+
+    if (!texts.isEmpty()) {
+        QFont font = painter.font();
+        font.setBold(true);
+        painter.setFont(font);
+        for (const FloatingText& t : texts) {
+            QColor color = t.color;
+            color.setAlpha(255 - 255 * t.ageMs / TEXT_LIFE_MS);
+            painter.setPen(color);
+            painter.drawText(qRound(t.x) - cameraLeft, qRound(t.y), t.text);
+        }
+    }
+}
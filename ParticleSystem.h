@@ -0,0 +1,81 @@
+#ifndef PARTICLE_SYSTEM_H
+#define PARTICLE_SYSTEM_H
+
+#include <QWidget>
+#include <QColor>
+#include <QRectF>
+#include <QString>
+#include <QVector>
+#include <cstdint>
+#include <vector>
+#include "Simulation.h"
+
+// 粒子特效：受击火花、回血、护甲碎片、拾取闪光。
+// 粒子按属性分别存放在定长数组中，存活的粒子始终连续排列；每个模拟帧统一更新一次，
+// 绘制时按种类和透明度分组，每组一次 drawRects。
+// 整个系统是覆盖在游戏区域上方的一个控件，不接收鼠标事件
+class ParticleSystem : public QWidget {
+    Q_OBJECT
+public:
+    enum Kind { SPARK, HEAL, DEBRIS, GLINT, KIND_COUNT };
+
+    static constexpr int CAPACITY = 4096;     // 同时存在的最大粒子数
+    static constexpr int FRAME_BUDGET = 512;  // 每个显示帧最多新增的粒子数，超出的直接丢弃
+    static constexpr int FADE_LEVELS = 4;     // 淡出分组数（每组一个透明度）
+    static constexpr int MAX_TEXTS = 16;      // 同时显示的飘字数
+
+    explicit ParticleSystem(QWidget *parent = nullptr);
+
+    // 在 (x, y)（关卡坐标）处产生 count 个粒子，返回实际产生的数量
+    int spawn(Kind kind, int x, int y, int count);
+
+    // 飘字（回血数值等），向上漂移后消失
+    void spawnText(const QString &text, int x, int y, const QColor &color);
+
+    // 推进所有粒子
+    void step(int ms);
+
+    // 新的显示帧：重置新增粒子预算
+    void beginFrame() { frameSpawned = 0; }
+
+    // 镜头左边缘（关卡坐标）
+    void setCameraLeft(int left);
+
+    void clear();
+
+    int count() const { return particleCount; }
+    int64_t dropped() const { return droppedTotal; }
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    void removeAt(int index);
+
+    // 按属性分别存放
+    float posX[CAPACITY];
+    float posY[CAPACITY];
+    float velX[CAPACITY];
+    float velY[CAPACITY];
+    int16_t ageMs[CAPACITY];
+    int16_t lifeMs[CAPACITY];
+    uint8_t kinds[CAPACITY];
+    int particleCount = 0;
+
+    struct FloatingText {
+        QString text;
+        QColor color;
+        float x = 0;
+        float y = 0;
+        int ageMs = 0;
+    };
+    QVector<FloatingText> texts;
+
+    int frameSpawned = 0;
+    int64_t droppedTotal = 0;
+    int cameraLeft = 0;
+    SimRng rng;                                          // 只影响显示，不参与对战
+    std::vector<QRectF> batches[KIND_COUNT][FADE_LEVELS]; // 绘制缓冲，跨帧复用
+};
+
+#endif // PARTICLE_SYSTEM_H
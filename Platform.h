@@ -1,10 +1,38 @@
 #ifndef PLATFORM_H
 #define PLATFORM_H
 
+#include <algorithm>
+
+// 线段 (x0, y0) + t * (dx, dy)（0 <= t <= 1）与矩形 [rx, rx+rw] x [ry, ry+rh] 求交（分轴裁剪）。
+// 相交时 t 为线段进入矩形处的参数，起点在矩形内时为0
+inline bool segmentIntersectsRect(double x0, double y0, double dx, double dy,
+                                  double rx, double ry, double rw, double rh, double &t) {
+    const double origin[2] = {x0, y0};
+    const double direction[2] = {dx, dy};
+    const double low[2] = {rx, ry};
+    const double high[2] = {rx + rw, ry + rh};
+    double enter = 0.0, leave = 1.0;
+    for (int axis = 0; axis < 2; axis++) {
+        if (direction[axis] == 0.0) {
+            if (origin[axis] < low[axis] || origin[axis] > high[axis]) return false;
+            continue;
+        }
+        double t0 = (low[axis] - origin[axis]) / direction[axis];
+        double t1 = (high[axis] - origin[axis]) / direction[axis];
+        if (t0 > t1) std::swap(t0, t1);
+        enter = std::max(enter, t0);
+        leave = std::min(leave, t1);
+        if (enter > leave) return false;
+    }
+    t = enter;
+    return true;
+}
+
 // 平台结构体
 struct Platform {
     int x, y, width, height;
     int type; // 0: 普通, 1: 草地, 2: 冰面
+    Platform() : x(0), y(0), width(0), height(0), type(0) {}
     Platform(int x, int y, int w, int h, int t = 0) : x(x), y(y), width(w), height(h), type(t) {}
 
     // 检查点是否在平台上
@@ -0,0 +1,723 @@
+#include "Simulation.h"
+#include "HitTest.h"
+#include <algorithm>
+#include <cstdlib>
+
+static_assert(Level::ITEM_TYPE_COUNT == SimItem::TYPE_COUNT, "关卡道具生成表与道具类型数量不一致");
+
+using SimPhysics::SUBPIXEL;
+using SimPhysics::GRAVITY;
+
+namespace {
+constexpr int TERRAIN_INTERVAL_MS = 100;
+constexpr int ADRENALINE_INTERVAL_MS = 250;
+constexpr int ADRENALINE_DURATION = 10000;
+constexpr int INVINCIBLE_MS = 300;
+constexpr int BALL_DAMAGE = 15;
+constexpr int RIFLE_DAMAGE = 10;
+constexpr int SNIPER_DAMAGE = 40;
+constexpr int SPAWN_SPACING = 80;     // 出生点不够时，后面的玩家依次错开
+
+// 近战时间轴，与 res/animations.txt 中的特效对齐：
+// 拳头特效10帧 x 50ms，第3帧出拳（impact 事件），收招的第8~9帧再判定一次（范围较小）；
+// 小刀特效200ms，挥出即判定
+const MeleeTimeline FIST_TIMELINE = {500, 2, {
+    {100, 200, 0, 0, 100, 100, 2},
+    {350, 450, 0, 20, 80, 60, 2},
+}};
+const MeleeTimeline KNIFE_TIMELINE = {200, 1, {
+    {0, 150, 0, 0, 100, 100, 5},
+}};
+const MeleeTimeline NO_TIMELINE = {};
+
+static_assert(MeleeTimeline::MAX_HITBOXES * SimWorld::MAX_PLAYERS <= 32, "SimCharacter::meleeHits 位数不足");
+
+// 四舍五入的整数除法（d > 0）
+int64_t divRound(int64_t n, int64_t d) {
+    return n >= 0 ? (n + d / 2) / d : -((-n + d / 2) / d);
+}
+
+// 以速度 velocity（亚像素/秒）和加速度 accel（亚像素/秒²）经过 dtUs 微秒的位移（亚像素）。
+// 按匀加速运动的解析解积分，轨迹与帧长无关，不同频率只是在同一条轨迹上取样的时刻不同
+int64_t displacement(int64_t velocity, int64_t accel, int dtUs) {
+    return divRound(velocity * dtUs * 2000000 + accel * dtUs * dtUs, 2000000000000LL);
+}
+
+// 经过 dtUs 微秒的速度变化
+int velocityChange(int64_t accel, int dtUs) {
+    return static_cast<int>(divRound(accel * dtUs, 1000000));
+}
+
+// 把位移 delta（亚像素）加到像素坐标 pos 和亚像素余量 sub 上，余量保持在 [0, SUBPIXEL)
+void addSubpixels(int& pos, int& sub, int64_t delta) {
+    int64_t total = static_cast<int64_t>(pos) * SUBPIXEL + sub + delta;
+    int64_t whole = total >= 0 ? total / SUBPIXEL : -((-total + SUBPIXEL - 1) / SUBPIXEL);
+    pos = static_cast<int>(whole);
+    sub = static_cast<int>(total - whole * SUBPIXEL);
+}
+}
+
+SimWorld::SimWorld() {
+    reset(0);
+}
+
+SimWorld::SimWorld(const SimWorld& other, std::pmr::memory_resource *memory)
+    : items(memory), projectiles(memory), events(memory) {
+    *this = other;
+}
+
+void SimWorld::reset(uint64_t seed, std::shared_ptr<const Level> arena, int players, int teams) {
+    level = arena ? arena : Level::classic();
+    playerCount = std::max(1, std::min(players, MAX_PLAYERS));
+
+    int spawnCount = static_cast<int>(level->playerSpawns.size());
+    for (int i = 0; i < MAX_PLAYERS; i++) {
+        const LevelPoint& spawn = level->playerSpawns[i % spawnCount];
+        int offset = (i / spawnCount) * SPAWN_SPACING;
+        characters[i] = SimCharacter();
+        characters[i].x = spawn.x < level->width / 2 ? spawn.x + offset : spawn.x - offset;
+        characters[i].y = spawn.y - characters[i].height;
+        characters[i].facingRight = false;
+        characters[i].team = teams > 0 ? i % teams : i;
+        previousInput[i] = 0;
+        stats[i] = SimStats();
+        tracers[i] = SimTracer();
+    }
+
+    items.clear();
+    projectiles.clear();
+    events.clear();
+    std::copy(level->itemIntervalMs, level->itemIntervalMs + SimItem::TYPE_COUNT, spawnRemainingMs);
+    spawning = false;
+    tick = 0;
+    elapsedUs = 0;
+    elapsedMs = 0;
+    nextEntityId = 1;
+    rng.reseed(seed);
+}
+
+void SimWorld::setCharacterSize(int index, int width, int height) {
+    SimCharacter& c = characters[index];
+    c.y += c.height - height;
+    c.width = width;
+    c.height = height;
+}
+
+void SimWorld::startSpawning() {
+    spawning = true;
+    std::copy(level->itemIntervalMs, level->itemIntervalMs + SimItem::TYPE_COUNT, spawnRemainingMs);
+}
+
+void SimWorld::setTickRate(int hz) {
+    tickUs = hz > 0 ? 1000000 / std::max(MIN_TICK_HZ, std::min(hz, MAX_TICK_HZ)) : DEFAULT_TICK_US;
+}
+
+int SimWorld::winner() const {
+    int aliveTeam = -1;
+    for (int i = 0; i < playerCount; i++) {
+        if (!isAlive(i)) continue;
+        if (aliveTeam < 0) aliveTeam = characters[i].team;
+        else if (characters[i].team != aliveTeam) return 0;
+    }
+    return aliveTeam < 0 ? DRAW : aliveTeam + 1;
+}
+
+int SimWorld::nearestEnemy(int index) const {
+    const SimCharacter& me = characters[index];
+    int best = -1;
+    int bestDistance = 0;
+    for (int i = 0; i < playerCount; i++) {
+        const SimCharacter& other = characters[i];
+        if (other.team == me.team || !isAlive(i)) continue;
+        int distance = std::abs(other.x - me.x) + std::abs(other.y - me.y);
+        if (best < 0 || distance < bestDistance) {
+            best = i;
+            bestDistance = distance;
+        }
+    }
+    return best;
+}
+
+// 倒下的玩家不再行动。各定时器按本帧经过的整毫秒数推进
+// （帧长不是整毫秒时相邻帧交替取整，累计时间不会漂移）
+void SimWorld::step(const TickInput input[]) {
+    int64_t nextUs = elapsedUs + tickUs;
+    int stepMs = static_cast<int>(nextUs / 1000 - elapsedMs);
+    events.clear();
+
+    for (int i = 0; i < playerCount; i++) {
+        if (!isAlive(i)) continue;
+        applyInput(i, input[i], stepMs);
+        previousInput[i] = input[i].held;
+    }
+
+    for (int i = 0; i < playerCount; i++) {
+        if (isAlive(i)) stepCharacter(i, stepMs);
+    }
+
+    resolveMelee(stepMs);
+    for (int i = 0; i < playerCount; i++) {
+        tracers[i].remainingMs = std::max(0, tracers[i].remainingMs - stepMs);
+    }
+
+    if (spawning) {
+        for (int t = 0; t < SimItem::TYPE_COUNT; t++) {
+            if (level->itemIntervalMs[t] <= 0) continue;
+            spawnRemainingMs[t] -= stepMs;
+            if (spawnRemainingMs[t] <= 0) {
+                spawnRemainingMs[t] += level->itemIntervalMs[t];
+                spawnItem(static_cast<SimItem::Type>(t));
+            }
+        }
+    }
+
+    updateItems();
+    updateProjectiles();
+    elapsedUs = nextUs;
+    elapsedMs = nextUs / 1000;
+    tick++;
+}
+
+// 输入处理：每帧一次，按下沿触发动作，跳跃和攻击带输入缓冲
+void SimWorld::applyInput(int index, const TickInput& input, int stepMs) {
+    SimCharacter& c = characters[index];
+    uint8_t held = input.held;
+    uint8_t pressed = input.pressed;
+
+    // 下蹲（本帧内按下又松开视为一次拾取）
+    bool crouch = (held & INPUT_CROUCH) != 0;
+    if (crouch != c.crouching) {
+        c.crouching = crouch;
+        if (crouch) {
+            if (c.onGrass) c.visible = false;
+        } else {
+            c.visible = true;
+        }
+    }
+    if (pressed & INPUT_CROUCH) {
+        checkItemPickup(index);
+    }
+
+    // 水平移动：最近按下的方向优先，松开后回落到仍按住的方向
+    if (!c.crouching) {
+        int direction = c.moveDirection;
+        if (pressed & INPUT_LEFT) direction = -1;
+        if (pressed & INPUT_RIGHT) direction = 1;
+        if (direction < 0 && !(held & INPUT_LEFT)) direction = (held & INPUT_RIGHT) ? 1 : 0;
+        if (direction > 0 && !(held & INPUT_RIGHT)) direction = (held & INPUT_LEFT) ? -1 : 0;
+        if (direction != c.moveDirection) {
+            c.moveDirection = direction;
+            if (direction != 0) c.facingRight = direction > 0;
+        }
+    }
+
+    // 跳跃
+    if (pressed & INPUT_JUMP) c.jumpBufferMs = INPUT_BUFFER_MS;
+    if (c.jumpBufferMs > 0) {
+        c.jumpBufferMs = std::max(0, c.jumpBufferMs - stepMs);
+        if (!c.crouching && c.canJump) {
+            c.verticalVelocity = -SimPhysics::JUMP_SPEED;
+            c.canJump = false;
+            if (c.inAir) c.doubleJumpUsed = true;
+            c.inAir = true;
+            c.jumpBufferMs = 0;
+        }
+    }
+
+    // 攻击（枪械冷却中按下的攻击在冷却结束时触发）
+    if (pressed & INPUT_ATTACK) c.attackBufferMs = INPUT_BUFFER_MS;
+    if (c.attackBufferMs > 0) {
+        c.attackBufferMs = std::max(0, c.attackBufferMs - stepMs);
+        if (attack(index)) c.attackBufferMs = 0;
+    }
+}
+
+// 攻击，对应 Character::attack；返回是否成功出手
+bool SimWorld::attack(int index) {
+    SimCharacter& c = characters[index];
+    switch (c.weapon) {
+    case SimCharacter::FIST:
+    case SimCharacter::KNIFE:
+        // 出招中不重新开始，按键留在输入缓冲里，招式结束后再出手
+        if (c.meleeRemainingMs > 0) return false;
+        c.meleeRemainingMs = meleeTimeline(c.weapon).durationMs;
+        c.meleeHits = 0;
+        break;
+    case SimCharacter::BALL: {
+        c.ballUses--;
+        SimProjectile ball;
+        ball.id = nextEntityId++;
+        ball.kind = SimProjectile::BALL;
+        ball.x = c.x;
+        ball.y = c.y;
+        ball.velocityX = c.facingRight ? SimPhysics::BALL_SPEED_X : -SimPhysics::BALL_SPEED_X;
+        ball.velocityY = -SimPhysics::BALL_SPEED_Y;
+        ball.width = ball.height = 60;
+        ball.owner = index;
+        ball.damage = BALL_DAMAGE;
+        ball.low = c.crouching;
+        projectiles.push_back(ball);
+        if (c.ballUses <= 0) switchWeapon(index, SimCharacter::FIST);
+        break;
+    }
+    case SimCharacter::RIFLE:
+    case SimCharacter::SNIPER: {
+        bool sniper = c.weapon == SimCharacter::SNIPER;
+        int& ammo = sniper ? c.sniperAmmo : c.rifleAmmo;
+        int& cooldown = sniper ? c.sniperCooldownMs : c.rifleCooldownMs;
+        if (cooldown > 0) return false;
+        if (ammo <= 0) return true;
+
+        ammo--;
+        if (sniper) {
+            fireHitscan(index);
+        } else {
+            SimProjectile bullet;
+            bullet.id = nextEntityId++;
+            bullet.kind = SimProjectile::BULLET;
+            bullet.x = c.facingRight ? c.x + static_cast<int>(c.width * 0.4) : c.x - static_cast<int>(c.width * 0.1);
+            bullet.y = c.y + static_cast<int>(c.height * 0.5);
+            bullet.velocityX = c.facingRight ? SimPhysics::BULLET_SPEED : -SimPhysics::BULLET_SPEED;
+            bullet.width = c.width;
+            bullet.height = c.height;
+            bullet.owner = index;
+            bullet.damage = RIFLE_DAMAGE;
+            bullet.low = c.crouching;
+            projectiles.push_back(bullet);
+        }
+        cooldown = sniper ? 2000 : 500;
+        if (ammo <= 0) switchWeapon(index, SimCharacter::FIST);
+        break;
+    }
+    default:
+        break;
+    }
+    return true;
+}
+
+void SimWorld::stepCharacter(int index, int stepMs) {
+    SimCharacter& c = characters[index];
+    // 水平移动：按速度连续移动，新位置撞上平台侧面时停在原地
+    if (c.moveDirection != 0 && !c.crouching) {
+        int newX = c.x;
+        int newSubX = c.subX;
+        addSubpixels(newX, newSubX, c.moveDirection * displacement(c.moveSpeed, 0, tickUs));
+        bool collision = false;
+        level->forEachPlatform(newX, newX + c.width, [&](const Platform& p) {
+            bool onPlatform = (c.y + c.height >= p.y) &&
+                              (c.y + c.height <= p.y + 5) &&
+                              (newX + c.width > p.x) &&
+                              (newX < p.x + p.width);
+            collision = !onPlatform && p.intersects(newX, c.y, c.width, c.height);
+            return collision;
+        });
+        if (!collision) {
+            c.x = newX;
+            c.subX = newSubX;
+        }
+    }
+
+    applyGravity(c);
+
+    c.terrainAccumMs += stepMs;
+    if (c.terrainAccumMs >= TERRAIN_INTERVAL_MS) {
+        c.terrainAccumMs -= TERRAIN_INTERVAL_MS;
+        checkTerrainEffects(c);
+    }
+
+    if (c.adrenalineActive) {
+        c.adrenalineAccumMs += stepMs;
+        while (c.adrenalineActive && c.adrenalineAccumMs >= ADRENALINE_INTERVAL_MS) {
+            c.adrenalineAccumMs -= ADRENALINE_INTERVAL_MS;
+            heal(index, 1);
+            c.adrenalineRemainingMs -= ADRENALINE_INTERVAL_MS;
+            if (c.adrenalineRemainingMs <= 0) {
+                c.adrenalineActive = false;
+                c.moveSpeed = c.baseMoveSpeed;
+                checkTerrainEffects(c);
+            }
+        }
+    }
+
+    c.invincibleMs = std::max(0, c.invincibleMs - stepMs);
+    c.rifleCooldownMs = std::max(0, c.rifleCooldownMs - stepMs);
+    c.sniperCooldownMs = std::max(0, c.sniperCooldownMs - stepMs);
+}
+
+// 重力，对应 Character::applyGravity
+void SimWorld::applyGravity(SimCharacter& c) {
+    int newY = c.y;
+    int newSubY = c.subY;
+    addSubpixels(newY, newSubY, displacement(c.verticalVelocity, GRAVITY, tickUs));
+    c.verticalVelocity += velocityChange(GRAVITY, tickUs);
+
+    bool landed = false;
+    level->forEachPlatform(c.x, c.x + c.width, [&](const Platform& p) {
+        if (newY + c.height >= p.top() &&
+            c.y + c.height <= p.top() + 5 &&
+            c.x + c.width > p.x &&
+            c.x < p.x + p.width &&
+            c.verticalVelocity >= 0) {
+            c.y = p.top() - c.height;
+            c.subY = 0;
+            c.verticalVelocity = 0;
+            c.inAir = false;
+            c.canJump = true;
+            c.doubleJumpUsed = false;
+            landed = true;
+        }
+        return landed;
+    });
+    if (landed) return;
+
+    c.y = newY;
+    c.subY = newSubY;
+    if (c.y > level->height) {
+        LevelPoint respawn = level->respawnPointNear(c.x);
+        c.y = respawn.y;
+        c.x = respawn.x;
+        c.subX = c.subY = 0;
+        c.verticalVelocity = 0;
+    }
+    if (c.verticalVelocity != 0) {
+        c.inAir = true;
+    }
+}
+
+// 地形效果，对应 Character::checkTerrainEffects
+void SimWorld::checkTerrainEffects(SimCharacter& c) {
+    c.onGrass = false;
+    c.onIce = false;
+    level->forEachPlatform(c.x, c.x + c.width, [&](const Platform& p) {
+        bool onPlatform = (c.y + c.height >= p.y) &&
+                          (c.y + c.height <= p.y + 5) &&
+                          (c.x + c.width > p.x) &&
+                          (c.x < p.x + p.width);
+        if (onPlatform) {
+            if (p.type == 1) c.onGrass = true;
+            else if (p.type == 2) c.onIce = true;
+        }
+        return false;
+    });
+
+    if (c.onGrass) c.visible = !c.crouching;
+
+    // 速度以亚像素计，倍率不再截断到整像素
+    if (c.onIce) {
+        c.moveSpeed = c.adrenalineActive ? c.baseMoveSpeed * 2 : c.baseMoveSpeed * 3 / 2;
+    } else {
+        c.moveSpeed = c.adrenalineActive ? c.baseMoveSpeed * 3 / 2 : c.baseMoveSpeed;
+    }
+}
+
+// 狙击枪即时命中：从枪口沿朝向发出一条射线，先与平台求交确定射程，
+// 再在射程内找最近的可命中角色（规则同投射物）。每次射击只做这一次查询
+void SimWorld::fireHitscan(int index) {
+    const SimCharacter& c = characters[index];
+    int x0 = c.facingRight ? c.x + c.width : c.x;
+    int y0 = c.y + c.height * 5 / 8;    // 与子弹判定框的高度一致
+    int x1 = c.facingRight ? level->width + 50 : -50;
+    double range = 1.0;
+    level->raycast(x0, y0, x1, y0, range);
+
+    int target = -1;
+    for (int j = 0; j < playerCount; j++) {
+        const SimCharacter& other = characters[j];
+        if (j == index || !isAlive(j) || other.team == c.team) continue;
+        if (other.crouching && !c.crouching) continue;
+        double hit;
+        if (segmentIntersectsRect(x0, y0, x1 - x0, 0, other.x, other.y, other.width, other.height, hit) &&
+            hit < range) {
+            range = hit;
+            target = j;
+        }
+    }
+    if (target >= 0) takeDamage(target, SNIPER_DAMAGE, SimCharacter::SNIPER, index);
+
+    SimTracer& tracer = tracers[index];
+    tracer.x0 = x0;
+    tracer.y0 = y0;
+    tracer.x1 = x0 + static_cast<int>((x1 - x0) * range);
+    tracer.y1 = y0;
+    tracer.remainingMs = TRACER_MS;
+    tracer.hit = target >= 0;
+}
+
+const MeleeTimeline& SimWorld::meleeTimeline(SimCharacter::Weapon weapon) {
+    switch (weapon) {
+    case SimCharacter::FIST: return FIST_TIMELINE;
+    case SimCharacter::KNIFE: return KNIFE_TIMELINE;
+    default: return NO_TIMELINE;
+    }
+}
+
+// 判定框从角色中心朝前量起，朝左时以角色中心为轴镜像
+void SimWorld::hitboxRect(const SimCharacter& c, const MeleeHitbox& box, int& rx, int& ry, int& rw, int& rh) {
+    rw = c.width * box.width / 100;
+    rh = c.height * box.height / 100;
+    int forward = c.width * box.forward / 100;
+    rx = c.facingRight ? c.x + c.width / 2 + forward : c.x + c.width / 2 - forward - rw;
+    ry = c.y + c.height * box.top / 100;
+}
+
+// 近战结算：推进每个攻击者的动作时间，与本帧覆盖的时间段 [from, to) 有交集的判定框
+// 都参与测试，频率再低也不会漏掉短暂的判定帧。
+// 同一帧内同时结算：本帧开始时存活的玩家都可以出手
+void SimWorld::resolveMelee(int stepMs) {
+    bool aliveAtStart[MAX_PLAYERS];
+    for (int i = 0; i < playerCount; i++) aliveAtStart[i] = isAlive(i);
+
+    for (int i = 0; i < playerCount; i++) {
+        SimCharacter& attacker = characters[i];
+        if (!aliveAtStart[i] || attacker.meleeRemainingMs <= 0) continue;
+
+        const MeleeTimeline& timeline = meleeTimeline(attacker.weapon);
+        int from = timeline.durationMs - attacker.meleeRemainingMs;
+        int to = from + stepMs;
+        attacker.meleeRemainingMs = std::max(0, attacker.meleeRemainingMs - stepMs);
+
+        for (int h = 0; h < timeline.count; h++) {
+            const MeleeHitbox& box = timeline.hitboxes[h];
+            if (box.startMs >= to || box.endMs <= from) continue;
+            int rx, ry, rw, rh;
+            hitboxRect(attacker, box, rx, ry, rw, rh);
+            for (int j = 0; j < playerCount; j++) {
+                SimCharacter& target = characters[j];
+                uint32_t bit = 1u << (h * MAX_PLAYERS + j);
+                if (j == i || !aliveAtStart[j] || target.team == attacker.team) continue;
+                if ((attacker.meleeHits & bit) || !target.intersects(rx, ry, rw, rh)) continue;
+                if (attacker.crouching || !target.crouching) {
+                    attacker.meleeHits |= bit;
+                    takeDamage(j, box.damage, attacker.weapon, i);
+                }
+            }
+        }
+    }
+}
+
+// 投射物命中：全部投射物的判定框与存活角色批量测试（HitTest），再按投射物顺序结算。
+// 每个投射物只命中一个目标：不打发射者和队友，站着发射的打不中蹲下的目标
+void SimWorld::resolveProjectileHits() {
+    thread_local HitTest::Boxes boxes;
+    thread_local HitTest::Boxes targets;
+    thread_local std::vector<HitTest::Hit> hits;
+
+    int targetIndex[MAX_PLAYERS];
+    targets.clear();
+    for (int i = 0; i < playerCount; i++) {
+        if (!isAlive(i)) continue;
+        const SimCharacter& c = characters[i];
+        targetIndex[targets.size()] = i;
+        targets.add(c.x, c.y, c.width, c.height);
+    }
+    boxes.clear();
+    boxes.reserve(projectiles.size());
+    for (const SimProjectile& p : projectiles) {
+        int rx, ry, rw, rh;
+        p.hitbox(rx, ry, rw, rh);
+        boxes.add(rx, ry, rw, rh);
+    }
+    HitTest::collide(boxes, targets, hits);
+
+    for (const HitTest::Hit& hit : hits) {
+        SimProjectile& p = projectiles[hit.index];
+        if (!p.active || p.damage <= 0) continue;
+        int ownerTeam = characters[p.owner].team;
+        for (int t = 0; t < static_cast<int>(targets.size()); t++) {
+            if (!(hit.targets & (1u << t))) continue;
+            int j = targetIndex[t];
+            const SimCharacter& target = characters[j];
+            if (j == p.owner || target.team == ownerTeam || !isAlive(j)) continue;
+            if (target.crouching && !p.low) continue;
+            SimCharacter::Weapon source = p.kind == SimProjectile::BALL ? SimCharacter::BALL : SimCharacter::RIFLE;
+            takeDamage(j, p.damage, source, p.owner);
+            p.active = false;
+            break;
+        }
+    }
+}
+
+// 受伤害处理，对应 Character::takeDamage
+void SimWorld::takeDamage(int index, int damage, SimCharacter::Weapon source, int attacker) {
+    SimCharacter& c = characters[index];
+    if (c.invincibleMs > 0) return;
+
+    int durabilityBefore = c.bulletproofVest ? c.vestDurability : 0;
+
+    if (c.lightArmor) {
+        if (source == SimCharacter::FIST) damage = 0;
+        else if (source == SimCharacter::KNIFE) damage = 2;
+    } else if (c.bulletproofVest) {
+        if (source == SimCharacter::RIFLE) {
+            damage = 2;
+            c.vestDurability -= 10;
+        } else if (source == SimCharacter::SNIPER) {
+            damage = 10;
+            c.vestDurability -= 40;
+        }
+        if (c.vestDurability <= 0) c.bulletproofVest = false;
+        stats[index].armorDurabilityConsumed += durabilityBefore - std::max(0, c.vestDurability);
+    }
+
+    int dealt = std::min(damage, c.health);
+    stats[attacker].damageByWeapon[source] += dealt;
+    c.armorAbsorbedHit = (c.lightArmor && (source == SimCharacter::FIST || source == SimCharacter::KNIFE)) ||
+                         (c.bulletproofVest && (source == SimCharacter::RIFLE || source == SimCharacter::SNIPER));
+    c.health = std::max(0, c.health - damage);
+    c.invincibleMs = INVINCIBLE_MS;
+
+    SimEvent& hit = addEvent(SimEvent::DAMAGE, index, attacker, source, dealt);
+    if (c.armorAbsorbedHit) hit.flags |= SimEvent::ARMOR_ABSORBED;
+    if (durabilityBefore > 0 && !c.bulletproofVest) hit.flags |= SimEvent::ARMOR_BROKEN;
+    if (c.health == 0) addEvent(SimEvent::DEATH, index, attacker, source, 0);
+}
+
+void SimWorld::heal(int index, int amount) {
+    SimCharacter& c = characters[index];
+    int before = c.health;
+    c.health = std::min(100, c.health + amount);
+    if (c.health > before) addEvent(SimEvent::HEAL, index, index, 0, c.health - before);
+}
+
+void SimWorld::switchWeapon(int index, SimCharacter::Weapon weapon) {
+    if (characters[index].weapon == weapon) return;
+    characters[index].weapon = weapon;
+    addEvent(SimEvent::WEAPON_SWITCH, index, index, weapon, 0);
+}
+
+SimEvent& SimWorld::addEvent(SimEvent::Type type, int index, int other, int detail, int value) {
+    const SimCharacter& c = characters[index];
+    SimEvent event;
+    event.type = type;
+    event.player = static_cast<uint8_t>(index);
+    event.other = static_cast<uint8_t>(other);
+    event.detail = static_cast<uint8_t>(detail);
+    event.value = value;
+    event.x = c.x + c.width / 2;
+    event.y = c.y + c.height / 2;
+    events.push_back(event);
+    return events.back();
+}
+
+void SimWorld::activateAdrenaline(SimCharacter& c) {
+    c.adrenalineRemainingMs = ADRENALINE_DURATION;
+    if (!c.adrenalineActive) {
+        c.adrenalineActive = true;
+        c.moveSpeed = c.baseMoveSpeed * 3 / 2;
+    }
+}
+
+// 道具拾取，对应 GameScreen::checkItemPickup
+void SimWorld::checkItemPickup(int index) {
+    SimCharacter& c = characters[index];
+    int pickupX = c.x + c.width / 2;
+    int pickupY = c.y + c.height - 10;
+
+    for (int i = static_cast<int>(items.size()) - 1; i >= 0; i--) {
+        const SimItem& item = items[i];
+        if (pickupX < item.x || pickupX > item.x + SimItem::SIZE ||
+            pickupY < item.y || pickupY > item.y + SimItem::SIZE) {
+            continue;
+        }
+
+        SimEvent& pickup = addEvent(SimEvent::PICKUP, index, index, item.type, 0);
+        pickup.x = item.x + SimItem::SIZE / 2;
+        pickup.y = item.y + SimItem::SIZE / 2;
+        switch (item.type) {
+        case SimItem::BANDAGE: heal(index, 20); break;
+        case SimItem::MEDKIT: heal(index, 100); break;
+        case SimItem::ADRENALINE: activateAdrenaline(c); checkTerrainEffects(c); break;
+        case SimItem::KNIFE: switchWeapon(index, SimCharacter::KNIFE); break;
+        case SimItem::BALL: switchWeapon(index, SimCharacter::BALL); c.ballUses = 3; break;
+        case SimItem::RIFLE: switchWeapon(index, SimCharacter::RIFLE); c.rifleAmmo = 20; break;
+        case SimItem::SNIPER: switchWeapon(index, SimCharacter::SNIPER); c.sniperAmmo = 5; break;
+        case SimItem::LIGHT_ARMOR:
+            c.bulletproofVest = false;
+            c.lightArmor = true;
+            break;
+        case SimItem::BULLETPROOF_VEST:
+            c.lightArmor = false;
+            c.bulletproofVest = true;
+            c.vestDurability = 100;
+            break;
+        default:
+            break;
+        }
+        stats[index].itemsPickedUp[item.type]++;
+        items.erase(items.begin() + i);
+        break;
+    }
+}
+
+void SimWorld::spawnItem(SimItem::Type type) {
+    SimItem item;
+    item.id = nextEntityId++;
+    item.type = type;
+    item.x = rng.bounded(level->itemMinX, level->itemMaxX);
+    item.y = 0;
+    items.push_back(item);
+}
+
+// 道具下落，对应 Item::updatePosition
+void SimWorld::updateItems() {
+    for (SimItem& item : items) {
+        if (item.onGround) continue;
+
+        int newY = item.y;
+        int newSubY = item.subY;
+        addSubpixels(newY, newSubY, displacement(item.velocityY, GRAVITY, tickUs));
+        item.velocityY += velocityChange(GRAVITY, tickUs);
+        bool collided = false;
+        level->forEachPlatform(item.x, item.x + SimItem::SIZE, [&](const Platform& p) {
+            if (newY + SimItem::SIZE >= p.top() &&
+                item.y + SimItem::SIZE <= p.top() + 10 &&
+                item.x + SimItem::SIZE > p.x &&
+                item.x < p.x + p.width) {
+                item.y = p.top() - SimItem::SIZE;
+                item.subY = 0;
+                item.velocityY = 0;
+                item.onGround = true;
+                collided = true;
+            }
+            return collided;
+        });
+        if (!collided) {
+            item.y = newY;
+            item.subY = newSubY;
+            if (item.y > level->height) {
+                item.y = level->height - SimItem::SIZE;
+                item.subY = 0;
+                item.onGround = true;
+            }
+        }
+    }
+}
+
+// 投射物飞行，对应 BallProjectile / Bullet::updatePosition
+void SimWorld::updateProjectiles() {
+    const int arenaWidth = level->width;
+    for (SimProjectile& p : projectiles) {
+        if (p.kind == SimProjectile::BALL) {
+            addSubpixels(p.x, p.subX, displacement(p.velocityX, 0, tickUs));
+            addSubpixels(p.y, p.subY, displacement(p.velocityY, GRAVITY, tickUs));
+            p.velocityY += velocityChange(GRAVITY, tickUs);
+            if (p.x < 5 && p.velocityX < 0) {
+                p.velocityX = -p.velocityX;
+                p.x = 5;
+                p.subX = 0;
+            } else if (p.x > arenaWidth - 5 - p.width && p.velocityX > 0) {
+                p.velocityX = -p.velocityX;
+                p.x = arenaWidth - 5 - p.width;
+                p.subX = 0;
+            }
+            if (p.y > level->height || p.x < -100 || p.x > arenaWidth + 100) p.active = false;
+        } else {
+            addSubpixels(p.x, p.subX, displacement(p.velocityX, 0, tickUs));
+            if (p.x < -50 || p.x > arenaWidth + 50) p.active = false;
+        }
+    }
+    resolveProjectileHits();
+    projectiles.erase(std::remove_if(projectiles.begin(), projectiles.end(),
+                                     [](const SimProjectile& p) { return !p.active; }),
+                      projectiles.end());
+}
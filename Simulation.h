@@ -0,0 +1,298 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+#include "Level.h"
+#include "InputState.h"
+
+// 玩家输入位（与键盘按键一一对应）
+enum InputBit : uint8_t {
+    INPUT_LEFT   = 1 << 0,
+    INPUT_RIGHT  = 1 << 1,
+    INPUT_JUMP   = 1 << 2,
+    INPUT_CROUCH = 1 << 3,
+    INPUT_ATTACK = 1 << 4
+};
+
+// 确定性随机数发生器（xorshift64*），状态可直接拷贝
+struct SimRng {
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+
+    explicit SimRng(uint64_t seed = 0) { reseed(seed); }
+
+    void reseed(uint64_t seed) { state = seed ? seed : 0x9E3779B97F4A7C15ull; }
+
+    uint64_t next() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545F4914F6CDD1Dull;
+    }
+
+    // 返回 [lo, hi) 区间内的整数
+    int bounded(int lo, int hi) { return lo + static_cast<int>(next() % static_cast<uint64_t>(hi - lo)); }
+};
+
+// 物理常量：长度以亚像素为单位（1像素 = SUBPIXEL），速度和加速度按秒给出，与模拟频率无关。
+// 数值由原先每16ms一帧的整数常量换算而来
+namespace SimPhysics {
+constexpr int SUBPIXEL = 256;
+constexpr int GRAVITY = 1000000;        // 亚像素/秒²（原每帧 1 像素/帧）
+constexpr int JUMP_SPEED = 327902;      // 亚像素/秒，跳跃高度 210 像素与原先一致
+constexpr int MOVE_SPEED = 68267;       // 亚像素/秒（原每30ms 8 像素）
+constexpr int BALL_SPEED_X = 160000;    // 原 10 像素/帧
+constexpr int BALL_SPEED_Y = 240000;    // 原 15 像素/帧（向上）
+constexpr int BULLET_SPEED = 192000;    // 原 12 像素/帧
+}
+
+// 近战判定框：位置和大小按角色尺寸的百分比给出（适配不同精灵），朝向左时镜像。
+// 在攻击开始后的 [startMs, endMs) 内有效，每个判定框对同一目标只命中一次
+struct MeleeHitbox {
+    int startMs = 0;
+    int endMs = 0;
+    int forward = 0;    // 近端到角色中心的距离（%宽度）
+    int top = 0;        // 上沿到角色头顶的距离（%高度）
+    int width = 100;    // %宽度
+    int height = 100;   // %高度
+    int damage = 0;
+};
+
+// 一次近战攻击的判定时间轴
+struct MeleeTimeline {
+    static constexpr int MAX_HITBOXES = 4;
+    int durationMs = 0;         // 攻击动作时长（与特效一致）
+    int count = 0;
+    MeleeHitbox hitboxes[MAX_HITBOXES];
+};
+
+// 无界面的角色状态，规则与 Character 保持一致
+struct SimCharacter {
+    enum Weapon { FIST, KNIFE, BALL, RIFLE, SNIPER, WEAPON_COUNT }; // 与 Character::Weapon 顺序一致
+
+    int x = 0;
+    int y = 0;
+    int subX = 0;               // 不足一像素的位置（亚像素，0 ~ SUBPIXEL-1）
+    int subY = 0;
+    int width = 64;
+    int height = 96;
+    int team = 0;               // 队伍编号，同队之间不造成伤害
+
+    // 移动与重力
+    int moveDirection = 0;      // -1=左, 1=右, 0=停止
+    bool facingRight = false;
+    bool crouching = false;
+    bool visible = true;        // 草地下蹲时隐身
+    int verticalVelocity = 0;   // 亚像素/秒，向下为正
+    bool inAir = false;
+    bool canJump = true;
+    bool doubleJumpUsed = false;
+    int baseMoveSpeed = SimPhysics::MOVE_SPEED; // 亚像素/秒
+    int moveSpeed = SimPhysics::MOVE_SPEED;
+
+    // 战斗
+    int health = 100;
+    Weapon weapon = FIST;
+    int ballUses = 0;
+    int rifleAmmo = 0;
+    int sniperAmmo = 0;
+    int meleeRemainingMs = 0;   // 近战动作剩余时间（拳头500ms，小刀200ms）
+    uint32_t meleeHits = 0;     // 本次攻击已命中的目标：第 h 个判定框命中玩家 p 时置位 h*8+p
+    int invincibleMs = 0;
+    int rifleCooldownMs = 0;
+    int sniperCooldownMs = 0;
+    bool armorAbsorbedHit = false; // 最近一次受击是否被护甲抵挡（受击闪烁为黄色）
+
+    // 输入缓冲：提前按下的跳跃/攻击在一小段时间内条件满足时仍会触发
+    int jumpBufferMs = 0;
+    int attackBufferMs = 0;
+
+    // 地形与道具效果
+    bool onGrass = false;
+    bool onIce = false;
+    bool lightArmor = false;
+    bool bulletproofVest = false;
+    int vestDurability = 0;
+    bool adrenalineActive = false;
+    int adrenalineRemainingMs = 0;
+
+    // 各定时器的累计时间（对应 Character 中的 terrainEffectTimer/adrenalineTimer）
+    int terrainAccumMs = 0;
+    int adrenalineAccumMs = 0;
+
+    bool intersects(int rx, int ry, int rw, int rh) const {
+        return rx < x + width && x < rx + rw && ry < y + height && y < ry + rh;
+    }
+};
+
+// 无界面的道具状态
+struct SimItem {
+    enum Type { BANDAGE, MEDKIT, ADRENALINE, KNIFE, BALL, RIFLE, SNIPER, LIGHT_ARMOR, BULLETPROOF_VEST, TYPE_COUNT }; // 与 Item::ItemType 顺序一致
+    static constexpr int SIZE = 40;
+
+    int id = 0;
+    Type type = BANDAGE;
+    int x = 0;
+    int y = 0;
+    int subY = 0;
+    int velocityY = 0;          // 亚像素/秒
+    bool onGround = false;
+};
+
+// 无界面的投射物状态
+struct SimProjectile {
+    enum Kind { BALL, BULLET };  // 狙击枪为即时命中，没有投射物
+
+    int id = 0;
+    Kind kind = BALL;
+    int x = 0;
+    int y = 0;
+    int subX = 0;
+    int subY = 0;
+    int velocityX = 0;          // 亚像素/秒
+    int velocityY = 0;
+    int width = 0;
+    int height = 0;
+    int owner = 0;              // 发射者下标
+    int damage = 0;             // 命中伤害，0表示不造成伤害（压力测试负载）
+    bool low = false;           // 蹲下发射，可以打中蹲下的目标
+    bool active = true;
+
+    // 命中判定框：实心球为整个精灵；子弹精灵按角色尺寸绘制，只取上沿的一条
+    void hitbox(int& rx, int& ry, int& rw, int& rh) const {
+        rx = x;
+        ry = y;
+        rw = width;
+        rh = kind == BALL ? height : height / 4;
+    }
+};
+
+// 即时命中武器的弹道，只用于显示（枪口到命中点，持续一小段时间后消失）
+struct SimTracer {
+    int x0 = 0;
+    int y0 = 0;
+    int x1 = 0;
+    int y1 = 0;
+    int remainingMs = 0;
+    bool hit = false;           // 是否打中角色
+};
+
+// 一帧内发生的对战事件，按发生顺序记录，每帧开始时清空。
+// 帧结束后由模拟线程整批交给订阅方（遥测日志、界面的血条和特效），取代逐个对象的信号
+struct SimEvent {
+    enum Type : uint8_t { DAMAGE, HEAL, PICKUP, WEAPON_SWITCH, DEATH };
+    enum Flag : uint8_t {
+        ARMOR_ABSORBED = 1,     // DAMAGE：护甲挡下了这次攻击
+        ARMOR_BROKEN = 2        // DAMAGE：防弹衣耐久耗尽
+    };
+
+    Type type = DAMAGE;
+    uint8_t player = 0;         // 事件主体（受伤、恢复、拾取、换武器、倒下的玩家）
+    uint8_t other = 0;          // DAMAGE/DEATH：攻击者
+    uint8_t detail = 0;         // DAMAGE/DEATH：武器；PICKUP：道具类型；WEAPON_SWITCH：新武器
+    uint8_t flags = 0;          // Flag 的组合
+    int value = 0;              // DAMAGE：实际扣除的生命；HEAL：实际恢复的生命
+    int x = 0;                  // 发生位置：主体的中心，PICKUP 为道具中心
+    int y = 0;
+};
+
+// 单个玩家的对战统计（批量对战输出）
+struct SimStats {
+    int damageByWeapon[SimCharacter::WEAPON_COUNT] = {0, 0, 0, 0, 0}; // 按武器统计造成的伤害
+    int itemsPickedUp[SimItem::TYPE_COUNT] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+    int armorDurabilityConsumed = 0;  // 防弹衣耐久消耗
+};
+
+// 无界面的对战世界：可整体拷贝（用于AI前瞻搜索和批量对战）
+class SimWorld {
+public:
+    static constexpr int DEFAULT_TICK_US = 16000; // 默认每帧模拟时长（62.5 Hz）
+    static constexpr int MIN_TICK_HZ = 20;        // 可选的模拟频率范围
+    static constexpr int MAX_TICK_HZ = 240;
+    static constexpr int MAX_PLAYERS = 8;
+    static constexpr int INPUT_BUFFER_MS = 96;    // 输入缓冲时长（默认频率下6帧）
+    static constexpr int TRACER_MS = 150;         // 弹道显示时长
+    static constexpr int DRAW = -1;           // winner()：所有人同时倒下
+
+    SimWorld();
+
+    // 拷贝 other，道具和投射物从 memory 分配（推演用的临时世界放在 TickArena 上）。
+    // 普通拷贝构造的世界总是使用默认堆；赋值时保留自己的内存来源
+    SimWorld(const SimWorld& other, std::pmr::memory_resource *memory);
+    SimWorld(const SimWorld& other) = default;
+    SimWorld& operator=(const SimWorld& other) = default;
+
+    // 重置到指定关卡的出生点，arena 为空时使用标准竞技场。
+    // teams 为0时各自为战（队伍编号等于玩家下标），否则玩家 i 属于第 i % teams 队
+    void reset(uint64_t seed, std::shared_ptr<const Level> arena = nullptr, int players = 2, int teams = 0);
+
+    // 设置角色碰撞尺寸（取精灵帧大小），保持脚底位置不变
+    void setCharacterSize(int index, int width, int height);
+
+    // 开始按关卡的道具生成表定时生成道具
+    void startSpawning();
+
+    // 模拟频率，hz <= 0 时恢复默认；物理常量按秒给出，不同频率下游戏节奏相同。
+    // 不受 reset 影响，回放须使用录制时的频率
+    void setTickRate(int hz);
+    double tickRate() const { return 1e6 / tickUs; }
+
+    // 推进一帧，input 为各玩家本帧采样的输入（playerCount 个）
+    void step(const TickInput input[]);
+
+    // 最后存活的队伍：0=未结束，DRAW=同时全部倒下，否则为队伍编号+1（各自为战时即玩家编号）
+    int winner() const;
+    bool isOver() const { return winner() != 0; }
+
+    bool isAlive(int index) const { return characters[index].health > 0; }
+
+    // 离 index 最近的存活对手，没有时返回 -1
+    int nearestEnemy(int index) const;
+
+    // 武器的近战时间轴，远程武器为空
+    static const MeleeTimeline& meleeTimeline(SimCharacter::Weapon weapon);
+
+    // 判定框在关卡中的位置
+    static void hitboxRect(const SimCharacter& c, const MeleeHitbox& box, int& rx, int& ry, int& rw, int& rh);
+
+    std::shared_ptr<const Level> level; // 关卡数据只读共享，拷贝世界时不复制
+    int playerCount = 2;
+    SimCharacter characters[MAX_PLAYERS];
+    std::pmr::vector<SimItem> items;
+    std::pmr::vector<SimProjectile> projectiles;
+    int spawnRemainingMs[SimItem::TYPE_COUNT];
+    bool spawning = false;
+    int tickUs = DEFAULT_TICK_US;   // 每帧模拟时长（微秒）
+    int64_t tick = 0;               // 已推进的帧数
+    int64_t elapsedUs = 0;
+    int64_t elapsedMs = 0;          // elapsedUs 取整到毫秒，各定时器按它推进
+    uint8_t previousInput[MAX_PLAYERS] = {}; // 上一帧按住的键
+    int nextEntityId = 1;                          // 道具/投射物编号，界面据此对应控件
+    SimRng rng;
+    SimStats stats[MAX_PLAYERS];
+    SimTracer tracers[MAX_PLAYERS];     // 各玩家最近一次即时命中射击
+    std::pmr::vector<SimEvent> events;  // 本帧的事件
+
+private:
+    void applyInput(int index, const TickInput& input, int stepMs);
+    bool attack(int index);
+    void fireHitscan(int index);
+    void stepCharacter(int index, int stepMs);
+    void applyGravity(SimCharacter& c);
+    void checkTerrainEffects(SimCharacter& c);
+    void resolveMelee(int stepMs);
+    void checkItemPickup(int index);
+    void spawnItem(SimItem::Type type);
+    void updateItems();
+    void updateProjectiles();
+    void resolveProjectileHits();
+    void takeDamage(int index, int damage, SimCharacter::Weapon source, int attacker);
+    void heal(int index, int amount);
+    void switchWeapon(int index, SimCharacter::Weapon weapon);
+    SimEvent& addEvent(SimEvent::Type type, int index, int other, int detail, int value);
+    static void activateAdrenaline(SimCharacter& c);
+};
+
+#endif // SIMULATION_H
@@ -0,0 +1,166 @@
+#include "SimulationThread.h"
+#include "Telemetry.h"
+#include <chrono>
+
+namespace {
+const int64_t SPIN_NS = 1000000;    // 计划时刻前最后这段时间不睡眠，只让出时间片
+}
+
+SimulationThread::SimulationThread() {
+    simProbe.setReplayCapture(LatencyProbe::DEFAULT_REPLAY_CAPACITY);
+}
+
+SimulationThread::~SimulationThread() {
+    stop();
+}
+
+int64_t SimulationThread::nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void SimulationThread::reset(uint64_t seed, std::shared_ptr<const Level> level, int players, int teams) {
+    simWorld.reset(seed, level, players, teams);
+    simProbe.clear();   // 回放只记录这一局的输入
+    spawnTickValue = -1;
+    restoredWorld = false;
+    newWorld = true;
+}
+
+void SimulationThread::worldRestored() {
+    simProbe.clear();
+    spawnTickValue = -1;
+    restoredWorld = true;
+    newWorld = true;
+}
+
+void SimulationThread::start() {
+    if (isRunning()) return;
+    // 新的世界（而不是暂停后继续）在遥测日志中标出，读档得到的世界标为续写
+    if (telemetry && newWorld) telemetry->recordMatchStart(simWorld, restoredWorld);
+    newWorld = false;
+
+    // 先发布当前世界，界面线程不会再读到停止前的旧帧
+    Frame& frame = frames.writeBuffer();
+    frame.previous = simWorld;
+    frame.current = simWorld;
+    publish(frame, nowNs(), 0);
+
+    stopRequested.store(false, std::memory_order_relaxed);
+    thread = std::thread(&SimulationThread::run, this);
+}
+
+void SimulationThread::stop() {
+    if (!isRunning()) return;
+    stopRequested.store(true, std::memory_order_relaxed);
+    thread.join();
+}
+
+bool SimulationThread::takeSampled(int64_t tick, LatencyProbe::Event& event) {
+    const LatencyProbe::Event* first = sampledEvents.front();
+    if (!first || first->tick >= tick) return false;
+    event = *first;
+    sampledEvents.pop();
+    return true;
+}
+
+bool SimulationThread::takeEvent(int64_t tick, SimEvent& event) {
+    const GameEvent* first = gameEvents.front();
+    if (!first || first->tick > tick) return false;
+    event = first->event;
+    gameEvents.pop();
+    return true;
+}
+
+void SimulationThread::discardEvents() {
+    while (gameEvents.front()) gameEvents.pop();
+}
+
+// 按计划时刻推进：睡到计划时刻前约1毫秒，剩下的时间让出时间片等待，
+// 减少系统定时器精度带来的抖动；落后太多时从当前时刻重新计时。
+// 帧长在线程启动前由 SimWorld::setTickRate 决定，运行中不变
+void SimulationThread::run() {
+    const int64_t tickNs = simWorld.tickUs * 1000LL;
+    int64_t next = nowNs() + tickNs;
+    while (!stopRequested.load(std::memory_order_relaxed)) {
+        int64_t remaining = next - nowNs();
+        if (remaining > 0) {
+            if (remaining > SPIN_NS) {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(remaining - SPIN_NS));
+            } else {
+                std::this_thread::yield();
+            }
+            continue;
+        }
+        if (-remaining > MAX_CATCH_UP_TICKS * tickNs) next = nowNs();
+
+        applyCommands();
+        if (!simWorld.isOver()) step(next);
+        next += tickNs;
+    }
+}
+
+// 输入事件按到达顺序写入按键状态，由下一次 step 统一采样
+void SimulationThread::applyCommands() {
+    Command command;
+    while (commands.pop(command)) {
+        if (command.player < 1 || command.player > SimWorld::MAX_PLAYERS) continue;
+        InputState& input = inputs[command.player - 1];
+        switch (command.type) {
+        case Command::PRESS:
+            input.press(command.bit);
+            simProbe.markInput(command.player, command.bit, true, command.measured, command.timeUs);
+            break;
+        case Command::RELEASE:
+            input.release(command.bit);
+            simProbe.markInput(command.player, command.bit, false, command.measured, command.timeUs);
+            break;
+        case Command::CLEAR_INPUT:
+            input.clear();
+            break;
+        case Command::START_SPAWNING:
+            spawnTickValue = simWorld.tick;
+            simWorld.startSpawning();
+            break;
+        }
+    }
+}
+
+// 模拟一帧：采样输入、推进世界，直接写进三重缓冲的后台槽
+void SimulationThread::step(int64_t tickNs) {
+    int64_t startNs = nowNs();
+    if (preTick) preTick(simWorld);
+
+    TickInput input[SimWorld::MAX_PLAYERS];
+    for (int i = 0; i < simWorld.playerCount; i++) {
+        input[i] = inputs[i].sample();
+    }
+    simProbe.markTick(simWorld.tick, LatencyProbe::nowUs());
+
+    Frame& frame = frames.writeBuffer();
+    frame.previous = simWorld;
+    simWorld.step(input);
+    frame.current = simWorld;
+    // 本帧事件整批交给订阅方：遥测在本线程直接写入队列，界面线程显示到这一帧时再取出
+    if (telemetry) telemetry->recordTick(simWorld);
+    for (const SimEvent& event : simWorld.events) {
+        GameEvent entry;
+        entry.tick = simWorld.tick;
+        entry.event = event;
+        if (!gameEvents.push(entry)) droppedEventCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 测量事件先于帧交给界面，界面显示这一帧时即可完成测量；队列满时丢弃
+    simProbe.takeSampled(sampled);
+    for (const LatencyProbe::Event& event : sampled) sampledEvents.push(event);
+
+    publish(frame, tickNs, nowNs() - startNs);
+}
+
+void SimulationThread::publish(Frame& frame, int64_t tickNs, int64_t stepNs) {
+    frame.tickNs = tickNs;
+    frame.stepNs = stepNs;
+    frame.replayEvents = simProbe.replayTrace().size();
+    frame.replayCapacity = simProbe.replayTrace().capacity();
+    frames.publish();
+}
@@ -0,0 +1,124 @@
+#ifndef SIMULATION_THREAD_H
+#define SIMULATION_THREAD_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "Simulation.h"
+#include "InputState.h"
+#include "LatencyProbe.h"
+#include "SpscQueue.h"
+#include "TripleBuffer.h"
+
+class Telemetry;
+
+// 模拟线程：在独立线程上按固定步长推进 SimWorld，绘制再慢也不影响模拟节奏。
+// 界面线程通过无锁队列投递带时间戳的输入，每帧结束后把前后两帧世界状态发布到三重缓冲，
+// 界面线程读取最新一份插值绘制。不依赖Qt
+class SimulationThread {
+public:
+    static constexpr int MAX_CATCH_UP_TICKS = 5;    // 落后超过该帧数时丢弃积压，避免越追越慢
+    static constexpr std::size_t QUEUE_CAPACITY = 1024;
+
+    // 界面线程投递的命令
+    struct Command {
+        enum Type : uint8_t { PRESS, RELEASE, CLEAR_INPUT, START_SPAWNING };
+        Type type = PRESS;
+        uint8_t player = 1;       // 从1开始
+        uint8_t bit = 0;          // InputBit
+        bool measured = false;    // 是否计入延迟统计
+        int64_t timeUs = 0;       // 事件时刻（LatencyProbe::nowUs）
+    };
+
+    // 发给界面线程的对战事件，tick 为产生它的那一帧推进后的帧号
+    struct GameEvent {
+        int64_t tick = 0;
+        SimEvent event;
+    };
+    static constexpr std::size_t EVENT_CAPACITY = 4096;
+
+    // 发布给界面线程的一帧
+    struct Frame {
+        SimWorld previous;        // 本帧推进前的状态（插值用）
+        SimWorld current;
+        int64_t tickNs = 0;       // 本帧的计划时刻（nowNs），界面据此计算插值比例
+        int64_t stepNs = 0;       // 推进本帧实际花费的时间
+        std::size_t replayEvents = 0;   // 已记录的回放事件数与容量（内存统计用）
+        std::size_t replayCapacity = 0;
+    };
+
+    SimulationThread();
+    ~SimulationThread();
+
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    // 以下在线程停止时调用：重置对战、直接访问世界和回放记录、设置每帧之前执行的回调
+    void reset(uint64_t seed, std::shared_ptr<const Level> level, int players, int teams);
+    SimWorld& world() { return simWorld; }
+    const LatencyProbe& probe() const { return simProbe; }
+    int64_t spawnTick() const { return spawnTickValue; }
+    void setPreTickHook(std::function<void(SimWorld&)> hook) { preTick = std::move(hook); }
+
+    // 线程停止时调用：世界已被直接改写（读档）。这样的世界不能从种子重现，
+    // 清空回放记录，之后不再导出回放，直到下一次 reset
+    void worldRestored();
+    bool replayUsable() const { return !restoredWorld; }
+
+    // 遥测日志（可为空）：reset 或读档后第一次启动时记录一局的开始，此后每帧记录事件。本线程是它唯一的生产者
+    void setTelemetry(Telemetry *log) { telemetry = log; }
+
+    // 发布当前世界作为第一帧，然后启动线程；stop 等待线程退出
+    void start();
+    void stop();
+    bool isRunning() const { return thread.joinable(); }
+
+    // 界面线程：投递命令，队列满时丢弃并返回 false
+    bool post(const Command& command) { return commands.push(command); }
+
+    // 界面线程：切换到最新发布的一帧，返回是否有新帧
+    bool update() { return frames.update(); }
+    const Frame& frame() const { return frames.readBuffer(); }
+
+    // 界面线程：取出一个已被 tick 之前的模拟帧采样的测量事件
+    bool takeSampled(int64_t tick, LatencyProbe::Event& event);
+
+    // 界面线程：取出一个帧号不超过 tick 的对战事件（按发生顺序）。
+    // 队列满时丢弃的事件只计数，界面据此整体刷新一次；discardEvents 在线程停止时清空队列
+    bool takeEvent(int64_t tick, SimEvent& event);
+    uint64_t droppedEvents() const { return droppedEventCount.load(std::memory_order_relaxed); }
+    void discardEvents();
+
+    // 单调时钟（纳秒），与 Frame::tickNs 一致
+    static int64_t nowNs();
+
+private:
+    void run();
+    void applyCommands();
+    void step(int64_t tickNs);
+    void publish(Frame& frame, int64_t tickNs, int64_t stepNs);
+
+    // 只由模拟线程访问（线程停止时界面线程也可访问）
+    SimWorld simWorld;
+    InputState inputs[SimWorld::MAX_PLAYERS];
+    LatencyProbe simProbe;    // 采样时刻和回放记录
+    std::vector<LatencyProbe::Event> sampled;
+    int64_t spawnTickValue = -1;
+    bool restoredWorld = false;
+    bool newWorld = true;     // reset 或读档之后尚未启动过，启动时记录遥测的 MATCH_START
+    std::function<void(SimWorld&)> preTick;
+    Telemetry *telemetry = nullptr;
+
+    SpscQueue<Command, QUEUE_CAPACITY> commands;                 // 界面 -> 模拟
+    SpscQueue<LatencyProbe::Event, QUEUE_CAPACITY> sampledEvents; // 模拟 -> 界面
+    SpscQueue<GameEvent, EVENT_CAPACITY> gameEvents;               // 模拟 -> 界面
+    std::atomic<uint64_t> droppedEventCount{0};
+    TripleBuffer<Frame> frames;
+    std::thread thread;
+    std::atomic<bool> stopRequested{false};
+};
+
+#endif // SIMULATION_THREAD_H
@@ -0,0 +1,50 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+// 单生产者单消费者的无锁环形队列：一个线程只调用 push，另一个线程只调用 front/pop。
+// 容量固定（2的幂），队列满时 push 返回 false，不会阻塞也不会分配内存
+template <class T, std::size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "容量必须是2的幂");
+
+public:
+    // 生产者线程
+    bool push(const T& value) {
+        std::size_t tail = tailIndex.load(std::memory_order_relaxed);
+        if (tail - headIndex.load(std::memory_order_acquire) == Capacity) return false;
+        ring[tail & (Capacity - 1)] = value;
+        tailIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 消费者线程：队首元素，队列为空时返回 nullptr
+    const T* front() const {
+        std::size_t head = headIndex.load(std::memory_order_relaxed);
+        if (head == tailIndex.load(std::memory_order_acquire)) return nullptr;
+        return &ring[head & (Capacity - 1)];
+    }
+
+    // 消费者线程：丢弃队首元素（必须先由 front 确认非空）
+    void pop() {
+        headIndex.store(headIndex.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    bool pop(T& value) {
+        const T* first = front();
+        if (!first) return false;
+        value = *first;
+        pop();
+        return true;
+    }
+
+private:
+    // 读写位置分占不同的缓存行，避免两个线程互相使对方的缓存失效
+    alignas(64) std::atomic<std::size_t> headIndex{0};
+    alignas(64) std::atomic<std::size_t> tailIndex{0};
+    T ring[Capacity];
+};
+
+#endif // SPSC_QUEUE_H
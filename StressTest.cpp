@@ -0,0 +1,362 @@
+#include "StressTest.h"
+#include "Animation.h"
+#include "HitTest.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+namespace {
+const char* KIND_NAMES[StressTest::KIND_COUNT] = { "items", "bullets", "balls", "effects", "characters" };
+const char* KIND_LABELS[StressTest::KIND_COUNT] = { "道具", "子弹", "实心球", "攻击特效", "角色" };
+
+void printUsage() {
+    std::fprintf(stderr,
+                 "用法: 2DGame --stress [--headless] [--items N] [--bullets N] [--balls N] [--effects N]\n"
+                 "                      [--characters 2-8] [--ramp all|items,bullets,balls,effects,characters]\n"
+                 "                      [--stress-start N] [--stress-max N] [--seed S] [--level classic|wide]\n"
+                 "                      [--out stress_results.csv]\n"
+                 "      2DGame --stress --headless --hit-bench [--seed S]\n");
+}
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int countProjectiles(const SimWorld& world, SimProjectile::Kind kind) {
+    return static_cast<int>(std::count_if(world.projectiles.begin(), world.projectiles.end(),
+                                          [kind](const SimProjectile& p) { return p.kind == kind; }));
+}
+}
+
+StressTest::Ramp::Ramp(const Options& options) : options(options) {
+    samples.reserve(SAMPLE_FRAMES);
+    beginKind(0);
+}
+
+int StressTest::Ramp::limit(int kind) const {
+    return kind == CHARACTERS ? SimWorld::MAX_PLAYERS : options.maxCount;
+}
+
+void StressTest::Ramp::beginKind(int kind) {
+    current = kind;
+    while (current < KIND_COUNT && !options.ramp[current]) current++;
+    if (current == KIND_COUNT) return;
+
+    int start = current == CHARACTERS ? std::max(options.baseCount[current], 2)
+                                      : std::max(options.baseCount[current], options.startCount);
+    count = std::min(start, limit(current));
+    good = bad = -1;
+    goodP95Ms = 0.0;
+    frames = 0;
+    steps = 0;
+    samples.clear();
+}
+
+void StressTest::Ramp::finishKind() {
+    Result result;
+    result.kind = static_cast<Kind>(current);
+    result.maxSustained = good;
+    result.p95Ms = goodP95Ms;
+    result.steps = steps;
+    result.capped = bad < 0;
+    done.push_back(result);
+    beginKind(current + 1);
+}
+
+bool StressTest::Ramp::addFrame(int64_t frameNs) {
+    if (finished()) return false;
+    if (++frames <= WARMUP_FRAMES) return false;
+    samples.push_back(frameNs);
+    if (static_cast<int>(samples.size()) < SAMPLE_FRAMES) return false;
+
+    // 本档结束：按 P95 判断是否达标
+    std::sort(samples.begin(), samples.end());
+    int64_t p95 = samples[samples.size() * 95 / 100];
+    steps++;
+    if (p95 <= FRAME_BUDGET_NS) {
+        good = count;
+        goodP95Ms = p95 / 1e6;
+    } else {
+        bad = count;
+    }
+
+    int next = -1;
+    if (bad < 0) {
+        if (count < limit(current)) next = std::min(count * 2, limit(current));
+    } else if (good >= 0 && bad - good > std::max(1, good / 20)) {
+        next = good + (bad - good) / 2;
+    }
+    frames = 0;
+    samples.clear();
+    if (next < 0) {
+        finishKind();
+    } else {
+        count = next;
+    }
+    return true;
+}
+
+int StressTest::Ramp::target(Kind kind) const {
+    if (!finished() && kind == current) return count;
+    return options.baseCount[kind];
+}
+
+bool StressTest::isStressInvocation(int argc, char *argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--stress") == 0) return true;
+    }
+    return false;
+}
+
+bool StressTest::isHeadlessInvocation(int argc, char *argv[]) {
+    if (!isStressInvocation(argc, argv)) return false;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--headless") == 0) return true;
+    }
+    return false;
+}
+
+// 窗口模式与其他参数（--fps 等）共用命令行，不认识的参数直接跳过
+bool StressTest::parseOptions(int argc, char *argv[], Options& options) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (std::strcmp(arg, "--headless") == 0) {
+            options.headless = true;
+            continue;
+        }
+        if (std::strcmp(arg, "--hit-bench") == 0) {
+            options.hitBench = true;
+            continue;
+        }
+        if (!value) continue;
+
+        bool matched = true;
+        int kind = -1;
+        for (int k = 0; k < KIND_COUNT; k++) {
+            if (std::strcmp(arg + 2, KIND_NAMES[k]) == 0 && std::strncmp(arg, "--", 2) == 0) kind = k;
+        }
+        if (kind >= 0) {
+            options.baseCount[kind] = std::atoi(value);
+            if (options.baseCount[kind] < 0) return false;
+        } else if (std::strcmp(arg, "--ramp") == 0) {
+            std::string list = value;
+            for (int k = 0; k < KIND_COUNT; k++) {
+                options.ramp[k] = list == "all" || ("," + list + ",").find(std::string(",") + KIND_NAMES[k] + ",") != std::string::npos;
+            }
+        } else if (std::strcmp(arg, "--stress-start") == 0) {
+            options.startCount = std::atoi(value);
+        } else if (std::strcmp(arg, "--stress-max") == 0) {
+            options.maxCount = std::atoi(value);
+        } else if (std::strcmp(arg, "--seed") == 0) {
+            options.seed = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--level") == 0) {
+            options.level = value;
+        } else if (std::strcmp(arg, "--out") == 0) {
+            options.outputPath = value;
+        } else {
+            matched = false;
+        }
+        if (matched) i++;
+    }
+    int& characters = options.baseCount[CHARACTERS];
+    characters = std::max(1, std::min(characters, SimWorld::MAX_PLAYERS));
+    return options.startCount > 0 && options.maxCount >= options.startCount;
+}
+
+int StressTest::main(int argc, char *argv[]) {
+    // 关卡文件随可执行文件一起部署
+    std::string executable = argv[0];
+    size_t slash = executable.find_last_of("/\\");
+    if (slash != std::string::npos) Level::addSearchPath(executable.substr(0, slash) + "/levels");
+
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+    if (options.hitBench) return benchHitTest(options);
+    std::shared_ptr<const Level> level = Level::byName(options.level);
+    if (!level) {
+        std::fprintf(stderr, "未知关卡 %s\n", options.level.c_str());
+        return 1;
+    }
+
+    SimWorld world;
+    world.reset(options.seed, level, SimWorld::MAX_PLAYERS);
+    SimRng rng(options.seed);
+    TickInput input[SimWorld::MAX_PLAYERS];
+
+    // 无界面时攻击特效只有动画推进：与 fist_hit 相同的10帧 x 50ms，第3帧触发命中事件
+    AnimationClip effectClip;
+    effectClip.name = "stress_effect";
+    effectClip.loop = AnimationClip::LOOP;
+    for (int i = 0; i < 10; i++) {
+        AnimationFrame frame;
+        frame.durationMs = 50;
+        if (i == 2) frame.events.push_back("impact");
+        effectClip.frames.push_back(frame);
+        effectClip.lengthMs += frame.durationMs;
+    }
+    Animator animator;
+    std::vector<Animator::Handle> effects;
+    int64_t impacts = 0;
+
+    Ramp ramp(options);
+    while (!ramp.finished()) {
+        for (int k = 0; k < KIND_COUNT; k++) {
+            maintain(world, static_cast<Kind>(k), ramp.target(static_cast<Kind>(k)), rng);
+        }
+        int effectCount = ramp.target(EFFECTS);
+        while (static_cast<int>(effects.size()) > effectCount) {
+            animator.release(effects.back());
+            effects.pop_back();
+        }
+        while (static_cast<int>(effects.size()) < effectCount) {
+            Animator::Handle handle = animator.create();
+            animator.player(handle).listener = [&impacts](const std::string&) { impacts++; };
+            animator.play(handle, &effectClip);
+            effects.push_back(handle);
+        }
+
+        int64_t start = nowNs();
+        int64_t elapsedMs = world.elapsedMs;
+        world.step(input);
+        animator.step(static_cast<int>(world.elapsedMs - elapsedMs));
+        ramp.addFrame(nowNs() - start);
+    }
+
+    printResults(ramp.results(), true);
+    if (!writeCsv(options.outputPath, ramp.results(), true)) {
+        std::fprintf(stderr, "无法写入 %s\n", options.outputPath.c_str());
+        return 1;
+    }
+    return 0;
+}
+
+// 判定框随机分布在宽关卡范围内（子弹大小），角色沿地面排开，命中率与实际对战相近
+int StressTest::benchHitTest(const Options& options) {
+    const int counts[] = {1024, 4096, 16384, 65536};
+    const int64_t minNs = 200000000;    // 每项至少测 0.2 秒
+    SimRng rng(options.seed);
+
+    HitTest::Boxes targets;
+    for (int i = 0; i < SimWorld::MAX_PLAYERS; i++) targets.add(200 + i * 350, 500, 64, 96);
+
+    std::printf("%8s %8s %12s %12s %8s\n", "数量", "实现", "每次(us)", "每个(ns)", "命中");
+    for (int count : counts) {
+        HitTest::Boxes boxes;
+        boxes.reserve(count);
+        for (int i = 0; i < count; i++) boxes.add(rng.bounded(0, 3000), rng.bounded(0, 800), 64, 24);
+
+        std::vector<HitTest::Hit> expected, hits;
+        HitTest::collide(boxes, targets, expected, HitTest::SCALAR);
+        for (HitTest::Kernel kernel : {HitTest::SCALAR, HitTest::SSE2, HitTest::AVX2}) {
+            if (!HitTest::supported(kernel)) continue;
+            int64_t start = nowNs();
+            int64_t runs = 0;
+            while (nowNs() - start < minNs) {
+                HitTest::collide(boxes, targets, hits, kernel);
+                runs++;
+            }
+            double perCallNs = static_cast<double>(nowNs() - start) / runs;
+            bool same = hits.size() == expected.size() &&
+                        std::equal(hits.begin(), hits.end(), expected.begin(),
+                                   [](const HitTest::Hit& a, const HitTest::Hit& b) {
+                                       return a.index == b.index && a.targets == b.targets;
+                                   });
+            std::printf("%8d %8s %12.2f %12.3f %8zu%s\n", count, HitTest::kernelName(kernel), perCallNs / 1000,
+                        perCallNs / count, hits.size(), same ? "" : "  结果与标量实现不一致");
+            if (!same) return 1;
+        }
+    }
+    return 0;
+}
+
+// 测试负载不参与对战：道具随机落下，投射物从随机位置飞出，数量不足时每帧补充
+void StressTest::maintain(SimWorld& world, Kind kind, int count, SimRng& rng) {
+    const Level& level = *world.level;
+    switch (kind) {
+    case ITEMS:
+        if (static_cast<int>(world.items.size()) > count) world.items.resize(count);
+        while (static_cast<int>(world.items.size()) < count) {
+            SimItem item;
+            item.id = world.nextEntityId++;
+            item.type = static_cast<SimItem::Type>(rng.bounded(0, SimItem::TYPE_COUNT));
+            item.x = rng.bounded(0, std::max(1, level.width - SimItem::SIZE));
+            item.y = rng.bounded(0, std::max(1, level.height / 2));
+            world.items.push_back(item);
+        }
+        break;
+    case BULLETS:
+    case BALLS: {
+        SimProjectile::Kind projectileKind = kind == BULLETS ? SimProjectile::BULLET : SimProjectile::BALL;
+        int existing = countProjectiles(world, projectileKind);
+        for (auto it = world.projectiles.end(); existing > count && it != world.projectiles.begin();) {
+            --it;
+            if (it->kind == projectileKind) {
+                it = world.projectiles.erase(it);
+                existing--;
+            }
+        }
+        for (; existing < count; existing++) {
+            SimProjectile p;
+            p.id = world.nextEntityId++;
+            p.kind = projectileKind;
+            p.x = rng.bounded(0, std::max(1, level.width));
+            p.y = rng.bounded(50, std::max(51, level.height - 100));
+            bool right = rng.bounded(0, 2) == 1;
+            if (projectileKind == SimProjectile::BALL) {
+                p.velocityX = right ? SimPhysics::BALL_SPEED_X : -SimPhysics::BALL_SPEED_X;
+                p.velocityY = -SimPhysics::BALL_SPEED_Y * rng.bounded(5, 20) / 15;
+                p.width = p.height = 60;
+            } else {
+                p.velocityX = right ? SimPhysics::BULLET_SPEED : -SimPhysics::BULLET_SPEED;
+                p.width = 64;
+                p.height = 96;
+            }
+            p.owner = rng.bounded(0, world.playerCount);    // damage 为0：参与命中检测但不造成伤害
+            world.projectiles.push_back(p);
+        }
+        break;
+    }
+    case CHARACTERS:
+        world.playerCount = std::max(1, std::min(count, SimWorld::MAX_PLAYERS));
+        break;
+    default:
+        break; // 攻击特效由调用方维护
+    }
+}
+
+void StressTest::printResults(const std::vector<Result>& results, bool headless) {
+    std::printf("压力测试（%s），帧预算 %.2f ms，%u 个硬件线程\n", headless ? "无界面，仅模拟" : "窗口，模拟+绘制",
+                FRAME_BUDGET_NS / 1e6, std::thread::hardware_concurrency());
+    for (const Result& r : results) {
+        if (r.maxSustained < 0) {
+            std::printf("  %s: 固定负载已超出预算\n", KIND_LABELS[r.kind]);
+        } else {
+            std::printf("  %s: 最多 %d 个（P95 %.2f ms，测试 %d 档%s）\n",
+                        KIND_LABELS[r.kind], r.maxSustained, r.p95Ms, r.steps, r.capped ? "，已到上限" : "");
+        }
+    }
+}
+
+bool StressTest::writeCsv(const std::string& path, const std::vector<Result>& results, bool headless) {
+    std::ofstream out(path);
+    if (!out) return false;
+    out << "mode,kind,max_sustained,capped,p95_ms,steps,hardware_threads\n";
+    for (const Result& r : results) {
+        out << (headless ? "headless" : "windowed") << ',' << KIND_NAMES[r.kind] << ',' << r.maxSustained << ','
+            << (r.capped ? 1 : 0) << ',' << r.p95Ms << ',' << r.steps << ',' << std::thread::hardware_concurrency() << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+const char* StressTest::kindName(Kind kind) {
+    return KIND_NAMES[kind];
+}
@@ -0,0 +1,98 @@
+#ifndef STRESS_TEST_H
+#define STRESS_TEST_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Simulation.h"
+
+// 压力测试：在竞技场中逐步增加某一类实体的数量，直到帧耗时超出 60 FPS 的预算，
+// 报告每类实体能稳定维持的最大数量。
+// 无界面模式只计模拟耗时（--stress --headless），窗口模式计整帧（模拟+绘制）耗时（--stress）
+class StressTest {
+public:
+    enum Kind { ITEMS, BULLETS, BALLS, EFFECTS, CHARACTERS, KIND_COUNT };
+
+    static constexpr int64_t FRAME_BUDGET_NS = 1000000000LL / 60; // 60 FPS 的帧预算
+    static constexpr int WARMUP_FRAMES = 30;    // 数量变化后先丢弃的帧
+    static constexpr int SAMPLE_FRAMES = 120;   // 每档数量采样的帧数
+
+    struct Options {
+        int baseCount[KIND_COUNT] = {0, 0, 0, 0, 2};            // 固定负载（角色为总人数）
+        bool ramp[KIND_COUNT] = {true, true, true, true, true}; // 需要加压的实体类型
+        int startCount = 16;                // 加压起点
+        int maxCount = 1 << 20;             // 加压上限（角色最多 SimWorld::MAX_PLAYERS）
+        uint64_t seed = 1;
+        bool headless = false;
+        bool hitBench = false;              // 只测投射物命中检测内核（--hit-bench）
+        std::string level = "classic";
+        std::string outputPath = "stress_results.csv";
+    };
+
+    struct Result {
+        Kind kind = ITEMS;
+        int maxSustained = -1;  // 能维持 60 FPS 的最大数量，-1 表示固定负载本身已超预算
+        double p95Ms = 0.0;     // 该数量下帧耗时的 P95
+        int steps = 0;          // 测试过的数量档位
+        bool capped = false;    // 到达加压上限仍未超预算
+    };
+
+    // 加压过程：每类实体先倍增数量，超出预算后在最后一个达标数量和超标数量之间二分，
+    // 精度到 5%。其他类型保持固定负载
+    class Ramp {
+    public:
+        explicit Ramp(const Options& options);
+
+        // 记录一帧耗时，返回目标数量是否发生变化
+        bool addFrame(int64_t frameNs);
+
+        bool finished() const { return current == KIND_COUNT; }
+        Kind kind() const { return static_cast<Kind>(current); }
+
+        // 各类实体当前的目标数量
+        int target(Kind kind) const;
+
+        const std::vector<Result>& results() const { return done; }
+
+    private:
+        void beginKind(int kind);
+        void finishKind();
+        int limit(int kind) const;
+
+        Options options;
+        int current = 0;
+        int count = 0;
+        int good = -1;          // 最大的达标数量
+        int bad = -1;           // 最小的超标数量
+        double goodP95Ms = 0.0;
+        int frames = 0;
+        int steps = 0;
+        std::vector<int64_t> samples;
+        std::vector<Result> done;
+    };
+
+    // 命令行中是否包含 --stress，及是否同时包含 --headless
+    static bool isStressInvocation(int argc, char *argv[]);
+    static bool isHeadlessInvocation(int argc, char *argv[]);
+
+    // 解析 --stress 相关参数，格式错误时返回 false
+    static bool parseOptions(int argc, char *argv[], Options& options);
+
+    // 无界面入口，返回进程退出码
+    static int main(int argc, char *argv[]);
+
+    // 投射物命中检测内核的基准测试：数千到数万个判定框对8个角色，
+    // 比较各实现的耗时并核对结果一致
+    static int benchHitTest(const Options& options);
+
+    // 把世界中的道具、子弹、实心球或角色补足（或裁剪）到 count 个
+    static void maintain(SimWorld& world, Kind kind, int count, SimRng& rng);
+
+    // 输出结果到标准输出和CSV
+    static void printResults(const std::vector<Result>& results, bool headless);
+    static bool writeCsv(const std::string& path, const std::vector<Result>& results, bool headless);
+
+    static const char* kindName(Kind kind);
+};
+
+#endif // STRESS_TEST_H
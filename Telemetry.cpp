@@ -0,0 +1,225 @@
+#include "Telemetry.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(Telemetry::Record) == 24, "遥测记录为定长24字节");
+static_assert(static_cast<int>(Telemetry::DEATH) == static_cast<int>(SimEvent::DEATH), "前五种类型与 SimEvent 一致");
+
+namespace {
+const int WRITER_IDLE_MS = 20;      // 队列为空时写入线程的等待间隔
+
+int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Telemetry::Record characterRecord(const SimWorld& world, Telemetry::Type type, int index) {
+    const SimCharacter& c = world.characters[index];
+    Telemetry::Record record;
+    record.elapsedMs = world.elapsedMs;
+    record.type = type;
+    record.player = static_cast<uint8_t>(index);
+    record.x = c.x + c.width / 2;
+    record.y = c.y + c.height / 2;
+    return record;
+}
+}
+
+Telemetry::Telemetry() {
+}
+
+Telemetry::~Telemetry() {
+    stop();
+}
+
+bool Telemetry::start(const Options& startOptions) {
+    if (isRunning()) return true;
+    options = startOptions;
+    if (!openFile()) return false;
+    reportedDrops = dropped();
+    stopRequested.store(false, std::memory_order_relaxed);
+    writer = std::thread(&Telemetry::run, this);
+    return true;
+}
+
+void Telemetry::stop() {
+    if (!isRunning()) return;
+    stopRequested.store(true, std::memory_order_relaxed);
+    writer.join();
+    if (file) {
+        sync();
+        std::fclose(file);
+        file = nullptr;
+    }
+}
+
+void Telemetry::recordMatchStart(const SimWorld& world, bool continued) {
+    Record start;
+    start.elapsedMs = world.elapsedMs;
+    start.type = MATCH_START;
+    start.player = static_cast<uint8_t>(world.playerCount);
+    start.detail = continued ? MATCH_CONTINUED : 0;
+    start.value = world.tickUs;
+    start.x = world.level->width;
+    start.y = world.level->height;
+    record(start);
+
+    const std::string& name = world.level->name;
+    for (std::size_t offset = 0, chunk = 0; offset < name.size() && chunk <= UINT8_MAX; offset += LEVEL_NAME_CHUNK, chunk++) {
+        char bytes[LEVEL_NAME_CHUNK] = {};
+        std::size_t length = std::min<std::size_t>(LEVEL_NAME_CHUNK, name.size() - offset);
+        std::memcpy(bytes, name.data() + offset, length);
+        Record part;
+        part.elapsedMs = world.elapsedMs;
+        part.type = LEVEL_NAME;
+        part.player = static_cast<uint8_t>(chunk);
+        part.detail = static_cast<uint8_t>(length);
+        std::memcpy(&part.value, bytes, 4);
+        std::memcpy(&part.x, bytes + 4, 4);
+        std::memcpy(&part.y, bytes + 8, 4);
+        record(part);
+    }
+    nextSampleMs = world.elapsedMs;
+}
+
+void Telemetry::appendLevelName(std::string& name, const Record& record) {
+    char bytes[LEVEL_NAME_CHUNK];
+    std::memcpy(bytes, &record.value, 4);
+    std::memcpy(bytes + 4, &record.x, 4);
+    std::memcpy(bytes + 8, &record.y, 4);
+    name.append(bytes, std::min<std::size_t>(record.detail, LEVEL_NAME_CHUNK));
+}
+
+// 本帧事件按发生顺序写入；对战时间每过一个采样间隔记录一次所有存活角色
+void Telemetry::recordTick(const SimWorld& world) {
+    for (const SimEvent& event : world.events) {
+        Record entry;
+        entry.elapsedMs = world.elapsedMs;
+        entry.type = event.type;
+        entry.player = event.player;
+        entry.x = event.x;
+        entry.y = event.y;
+        entry.other = event.other;
+        entry.detail = event.detail;
+        entry.value = event.value;
+        record(entry);
+    }
+
+    if (world.elapsedMs < nextSampleMs) return;
+    nextSampleMs = (world.elapsedMs / SAMPLE_INTERVAL_MS + 1) * SAMPLE_INTERVAL_MS;
+    for (int i = 0; i < world.playerCount; i++) {
+        if (!world.isAlive(i)) continue;
+        Record sample = characterRecord(world, POSITION, i);
+        sample.detail = static_cast<uint8_t>(world.characters[i].weapon);
+        sample.value = world.characters[i].health;
+        record(sample);
+    }
+}
+
+void Telemetry::record(const Record& record) {
+    if (!queue.push(record)) droppedCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+// 写入线程：取空队列后整批写入；丢弃数有变化时补一条 DROPPED 记录
+void Telemetry::run() {
+    std::vector<Record> batch;
+    batch.reserve(QUEUE_CAPACITY);
+    int64_t lastSyncMs = nowMs();
+    for (;;) {
+        bool stopping = stopRequested.load(std::memory_order_relaxed);
+        Record entry;
+        while (batch.size() < QUEUE_CAPACITY && queue.pop(entry)) batch.push_back(entry);
+
+        uint64_t drops = droppedCount.load(std::memory_order_relaxed);
+        if (file && drops != reportedDrops) {
+            Record dropped;
+            dropped.elapsedMs = batch.empty() ? 0 : batch.back().elapsedMs;
+            dropped.type = DROPPED;
+            dropped.value = static_cast<int32_t>(drops - reportedDrops);
+            batch.push_back(dropped);
+            reportedDrops = drops;
+        }
+
+        bool idle = batch.empty();
+        if (!idle) {
+            writeBatch(batch.data(), batch.size());
+            batch.clear();
+        }
+        if (nowMs() - lastSyncMs >= options.syncIntervalMs) {
+            sync();
+            lastSyncMs = nowMs();
+        }
+        if (stopping && idle) break;
+        if (idle) std::this_thread::sleep_for(std::chrono::milliseconds(WRITER_IDLE_MS));
+    }
+}
+
+bool Telemetry::openFile() {
+    file = std::fopen(options.path.c_str(), "wb");
+    if (!file) return false;
+    FileHeader header = {};
+    std::memcpy(header.magic, MAGIC, 4);
+    header.version = VERSION;
+    header.recordSize = sizeof(Record);
+    header.createdMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::system_clock::now().time_since_epoch()).count();
+    std::fwrite(&header, sizeof(header), 1, file);
+    fileBytes = sizeof(header);
+    return true;
+}
+
+// 写入失败（磁盘满、轮换后无法打开）的记录计入丢弃数
+void Telemetry::writeBatch(const Record* records, std::size_t count) {
+    for (std::size_t i = 0; i < count; i++) {
+        if (records[i].type == MATCH_START) matchHeader.assign(1, records[i]);
+        else if (records[i].type == LEVEL_NAME && !matchHeader.empty()) matchHeader.push_back(records[i]);
+    }
+    if (count > 0) lastWrittenMs = records[count - 1].elapsedMs;
+
+    std::size_t done = file ? std::fwrite(records, sizeof(Record), count, file) : 0;
+    fileBytes += static_cast<int64_t>(done * sizeof(Record));
+    writtenCount.fetch_add(done, std::memory_order_relaxed);
+    if (done < count) droppedCount.fetch_add(count - done, std::memory_order_relaxed);
+    if (file && fileBytes >= options.maxFileBytes) rotate();
+}
+
+void Telemetry::sync() {
+    if (!file) return;
+    std::fflush(file);
+#ifdef _WIN32
+    _commit(_fileno(file));
+#else
+    fsync(fileno(file));
+#endif
+}
+
+// 当前文件改名为 path.1，已有的旧文件依次后移，超出保留数的删除
+void Telemetry::rotate() {
+    sync();
+    std::fclose(file);
+    file = nullptr;
+    auto rotated = [this](int n) { return options.path + "." + std::to_string(n); };
+    std::remove(rotated(options.keepFiles).c_str());
+    for (int n = options.keepFiles - 1; n >= 1; n--) {
+        std::rename(rotated(n).c_str(), rotated(n + 1).c_str());
+    }
+    if (options.keepFiles > 0) std::rename(options.path.c_str(), rotated(1).c_str());
+    if (openFile()) writeMatchHeader();
+}
+
+// 新文件以续写的 MATCH_START 和关卡名开头，单独分析这个文件时也知道关卡尺寸和名称
+void Telemetry::writeMatchHeader() {
+    if (matchHeader.empty()) return;
+    std::vector<Record> header = matchHeader;
+    header[0].detail = MATCH_CONTINUED;
+    for (Record& entry : header) entry.elapsedMs = lastWrittenMs;
+    std::size_t done = std::fwrite(header.data(), sizeof(Record), header.size(), file);
+    fileBytes += static_cast<int64_t>(done * sizeof(Record));
+    writtenCount.fetch_add(done, std::memory_order_relaxed);
+}
@@ -0,0 +1,112 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Simulation.h"
+#include "SpscQueue.h"
+
+// 对战遥测日志：模拟线程把每帧的事件（SimEvent）和每秒的位置采样转成定长记录放入无锁队列，
+// 后台线程批量写入二进制日志，定期同步到磁盘，超过大小后轮换文件。
+// 模拟线程不做任何文件操作，队列满时丢弃记录并计数，丢弃数也会写入日志。不依赖Qt
+//
+// 文件格式：FileHeader，之后是连续的 Record（小端，与写入的机器一致）
+class Telemetry {
+public:
+    static constexpr char MAGIC[4] = {'T', 'L', 'M', '1'};
+    static constexpr uint32_t VERSION = 2;                  // 2：增加续写的 MATCH_START 和 LEVEL_NAME
+    static constexpr std::size_t QUEUE_CAPACITY = 1 << 14;   // 记录数，约16秒满负荷的事件
+    static constexpr int SAMPLE_INTERVAL_MS = 1000;         // 位置采样间隔（对战时间）
+
+    // 前五种与 SimEvent::Type 一致
+    enum Type : uint8_t {
+        DAMAGE, HEAL, PICKUP, WEAPON_SWITCH, DEATH,
+        POSITION,       // 位置采样：x, y；value 为生命值，detail 为当前武器
+        MATCH_START,    // 新的一局：player 为人数，x, y 为关卡尺寸，value 为模拟帧长（微秒），
+                        // detail 为 MATCH_CONTINUED 时是轮换后在新文件开头补写的当前对局或读档继续的对局
+        DROPPED,        // 队列满丢弃的记录：value 为自上一条以来丢弃的数量
+        LEVEL_NAME      // 紧跟 MATCH_START 的关卡名：player 为段序号，detail 为本段字节数，
+                        // value、x、y 依次存放最多 LEVEL_NAME_CHUNK 个字节
+    };
+    static constexpr uint8_t MATCH_CONTINUED = 1;
+    static constexpr int LEVEL_NAME_CHUNK = 12;
+
+    struct Record {
+        int64_t elapsedMs = 0;  // 对战时间
+        uint8_t type = DAMAGE;
+        uint8_t player = 0;
+        uint8_t other = 0;
+        uint8_t detail = 0;
+        int32_t value = 0;
+        int32_t x = 0;          // 发生位置（角色中心，拾取为道具中心）
+        int32_t y = 0;
+    };
+
+    struct FileHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t recordSize;
+        uint32_t reserved;
+        int64_t createdMs;      // 创建时间（Unix 毫秒）
+    };
+
+    struct Options {
+        std::string path;                       // 当前文件，轮换后依次改名为 path.1、path.2…
+        int64_t maxFileBytes = 64LL << 20;      // 超过后轮换
+        int keepFiles = 4;                      // 保留的旧文件数
+        int syncIntervalMs = 1000;              // 同步到磁盘的间隔
+    };
+
+    Telemetry();
+    ~Telemetry();
+
+    Telemetry(const Telemetry&) = delete;
+    Telemetry& operator=(const Telemetry&) = delete;
+
+    // 打开日志并启动写入线程；stop 写完队列中剩余的记录后关闭文件
+    bool start(const Options& options);
+    void stop();
+    bool isRunning() const { return writer.joinable(); }
+
+    // 以下只由一个生产者线程调用（模拟线程；线程停止时界面线程也可调用）。不会阻塞
+    // continued：读档继续的对局，MATCH_START 标为 MATCH_CONTINUED，不计作新的一局
+    void recordMatchStart(const SimWorld& world, bool continued = false);
+    void recordTick(const SimWorld& world);
+    void record(const Record& record);
+
+    // 把一条 LEVEL_NAME 记录的字节接到 name 后面（分析日志时使用）
+    static void appendLevelName(std::string& name, const Record& record);
+
+    // 任意线程
+    uint64_t dropped() const { return droppedCount.load(std::memory_order_relaxed); }
+    uint64_t written() const { return writtenCount.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+    bool openFile();
+    void writeBatch(const Record* records, std::size_t count);
+    void writeMatchHeader();
+    void sync();
+    void rotate();
+
+    Options options;
+    std::FILE* file = nullptr;
+    int64_t fileBytes = 0;
+    uint64_t reportedDrops = 0;    // 写入线程：已写入日志的丢弃数
+    std::vector<Record> matchHeader;   // 写入线程：当前对局的 MATCH_START 和关卡名，轮换后补写到新文件
+    int64_t lastWrittenMs = 0;     // 写入线程：最近写入的记录的对战时间
+    int64_t nextSampleMs = 0;      // 生产者：下一次位置采样的对战时间
+
+    SpscQueue<Record, QUEUE_CAPACITY> queue;
+    std::atomic<uint64_t> droppedCount{0};
+    std::atomic<uint64_t> writtenCount{0};
+    std::thread writer;
+    std::atomic<bool> stopRequested{false};
+};
+
+#endif // TELEMETRY_H
@@ -0,0 +1,452 @@
+#include "TelemetryAnalytics.h"
+#include <QImage>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <thread>
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+const char* WEAPON_NAMES[SimCharacter::WEAPON_COUNT] = { "fist", "knife", "ball", "rifle", "sniper" };
+const char* ITEM_NAMES[SimItem::TYPE_COUNT] = {
+    "bandage", "medkit", "adrenaline", "knife", "ball", "rifle", "sniper", "light_armor", "bulletproof_vest"
+};
+// 各武器对应的道具，拳头没有
+const int WEAPON_ITEMS[SimCharacter::WEAPON_COUNT] = { -1, SimItem::KNIFE, SimItem::BALL, SimItem::RIFLE, SimItem::SNIPER };
+
+const std::size_t MIN_RANGE_RECORDS = 1 << 16;   // 单个任务的最少记录数
+const int RANGES_PER_THREAD = 8;                  // 任务数约为线程数的倍数，平衡各线程负载
+
+void printUsage() {
+    std::fprintf(stderr,
+                 "用法: 2DGame --analyze telemetry.bin [telemetry.bin.1 ...] [--out-dir DIR]\n"
+                 "                       [--level 关卡名] [--threads N]\n");
+}
+
+// 只读映射整个文件
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+#ifdef _WIN32
+        if (bytes) UnmapViewOfFile(bytes);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+        if (bytes) munmap(const_cast<char*>(bytes), length);
+        if (fd >= 0) close(fd);
+#endif
+    }
+
+    bool open(const std::string& path) {
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                           OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        LARGE_INTEGER fileSize;
+        if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) return false;
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) return false;
+        bytes = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        length = static_cast<std::size_t>(fileSize.QuadPart);
+        return bytes != nullptr;
+#else
+        fd = ::open(path.c_str(), O_RDONLY);
+        struct stat info;
+        if (fd < 0 || fstat(fd, &info) != 0 || info.st_size == 0) return false;
+        length = static_cast<std::size_t>(info.st_size);
+        void* address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address == MAP_FAILED) return false;
+        madvise(address, length, MADV_SEQUENTIAL);
+        bytes = static_cast<const char*>(address);
+        return true;
+#endif
+    }
+
+    const char* data() const { return bytes; }
+    std::size_t size() const { return length; }
+
+private:
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+    const char* bytes = nullptr;
+    std::size_t length = 0;
+};
+
+// 一个任务：某个文件中 [begin, end) 范围内开始的各局
+struct Range {
+    const Telemetry::Record* records = nullptr;
+    std::size_t count = 0;      // 文件中的记录总数
+    std::size_t begin = 0;
+    std::size_t end = 0;
+};
+
+std::size_t nextMatchStart(const Telemetry::Record* records, std::size_t count, std::size_t from) {
+    while (from < count && records[from].type != Telemetry::MATCH_START) from++;
+    return from;
+}
+
+// 热力图配色：由暗蓝经红、黄到白，按对数比例
+void heatColor(double t, uint8_t* rgb) {
+    static const double STOPS[][3] = { {30, 30, 90}, {200, 30, 30}, {250, 220, 40}, {255, 255, 255} };
+    double position = std::min(std::max(t, 0.0), 1.0) * 3;
+    int index = std::min(static_cast<int>(position), 2);
+    double f = position - index;
+    for (int c = 0; c < 3; c++) {
+        rgb[c] = static_cast<uint8_t>(STOPS[index][c] + (STOPS[index + 1][c] - STOPS[index][c]) * f + 0.5);
+    }
+}
+
+// 热力图上绘制的关卡：依次尝试指定的关卡（命令行、日志中记录的关卡名），都不符合尺寸时找尺寸一致的已知关卡
+std::shared_ptr<const Level> levelForArena(const std::vector<std::string>& preferred, int width, int height) {
+    std::vector<std::string> names = Level::availableNames();
+    names.insert(names.begin(), preferred.begin(), preferred.end());
+    for (const std::string& name : names) {
+        std::shared_ptr<const Level> level = Level::byName(name);
+        if (level && level->width == width && level->height == height) return level;
+    }
+    return nullptr;
+}
+}
+
+void TelemetryAnalytics::Totals::merge(const Totals& other) {
+    records += other.records;
+    matches += other.matches;
+    dropped += other.dropped;
+    for (int w = 0; w < SimCharacter::WEAPON_COUNT; w++) {
+        damage[w] += other.damage[w];
+        kills[w] += other.kills[w];
+        for (int b = 0; b < TTK_BUCKETS; b++) ttk[w][b] += other.ttk[w][b];
+    }
+    for (int t = 0; t < SimItem::TYPE_COUNT; t++) {
+        pickups[t] += other.pickups[t];
+        contested[t] += other.contested[t];
+    }
+    for (const auto& entry : other.heatmaps) {
+        std::vector<uint32_t>& cells = heatmaps[entry.first];
+        if (cells.empty()) cells.assign(entry.second.size(), 0);
+        for (std::size_t i = 0; i < cells.size(); i++) cells[i] += entry.second[i];
+    }
+    for (const auto& entry : other.levelNames) levelNames[entry.first].insert(entry.second.begin(), entry.second.end());
+}
+
+bool TelemetryAnalytics::isAnalyticsInvocation(int argc, char *argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--analyze") == 0) return true;
+    }
+    return false;
+}
+
+// 按顺序重放一段记录：位置取最近一条带有该玩家位置的记录，
+// 击杀耗时为击杀者第一次命中受害者到受害者倒下的时间
+void TelemetryAnalytics::accumulate(const Telemetry::Record* records, std::size_t count, Totals& totals) {
+    const int players = SimWorld::MAX_PLAYERS;
+    bool alive[players];
+    bool located[players];
+    int x[players] = {};
+    int y[players] = {};
+    int64_t firstHitMs[players][players];
+    std::vector<uint32_t>* heatmap = nullptr;
+    int columns = 0;
+    int rows = 0;
+    std::pair<int, int> arena;
+    std::string levelName;
+
+    auto startMatch = [&](int playerCount) {
+        for (int i = 0; i < players; i++) {
+            alive[i] = i < playerCount;
+            located[i] = false;
+            for (int j = 0; j < players; j++) firstHitMs[i][j] = -1;
+        }
+    };
+    startMatch(players);   // 文件从一局中途开始（轮换后的文件）时假定所有人存活
+
+    totals.records += count;
+    for (std::size_t i = 0; i < count; i++) {
+        const Telemetry::Record& r = records[i];
+        if (r.type == Telemetry::MATCH_START) {
+            if (r.detail != Telemetry::MATCH_CONTINUED) totals.matches++;   // 续写的是轮换前或存档前已开始的一局
+            startMatch(r.player);
+            arena = {r.x, r.y};
+            levelName.clear();
+            columns = (r.x + HEATMAP_CELL - 1) / HEATMAP_CELL;
+            rows = (r.y + HEATMAP_CELL - 1) / HEATMAP_CELL;
+            heatmap = columns > 0 && rows > 0 ? &totals.heatmaps[{r.x, r.y}] : nullptr;
+            if (heatmap && heatmap->empty()) heatmap->assign(static_cast<std::size_t>(columns) * rows, 0);
+            continue;
+        }
+        if (r.type == Telemetry::DROPPED) {
+            totals.dropped += static_cast<uint64_t>(r.value);
+            continue;
+        }
+        if (r.type == Telemetry::LEVEL_NAME) {
+            Telemetry::appendLevelName(levelName, r);
+            bool last = i + 1 == count || records[i + 1].type != Telemetry::LEVEL_NAME;
+            if (last && heatmap) totals.levelNames[arena].insert(levelName);
+            continue;
+        }
+        if (r.type > Telemetry::POSITION || r.player >= players) continue;
+
+        int p = r.player;
+        x[p] = r.x;
+        y[p] = r.y;
+        located[p] = true;
+        switch (r.type) {
+        case Telemetry::DAMAGE:
+            if (r.detail < SimCharacter::WEAPON_COUNT) totals.damage[r.detail] += r.value;
+            if (r.other < players && firstHitMs[p][r.other] < 0) firstHitMs[p][r.other] = r.elapsedMs;
+            break;
+        case Telemetry::PICKUP: {
+            if (r.detail >= SimItem::TYPE_COUNT) break;
+            totals.pickups[r.detail]++;
+            for (int q = 0; q < players; q++) {
+                if (q == p || !alive[q] || !located[q]) continue;
+                int64_t dx = x[q] - r.x;
+                int64_t dy = y[q] - r.y;
+                if (dx * dx + dy * dy <= static_cast<int64_t>(CONTEST_RADIUS) * CONTEST_RADIUS) {
+                    totals.contested[r.detail]++;
+                    break;
+                }
+            }
+            break;
+        }
+        case Telemetry::DEATH:
+            alive[p] = false;
+            if (r.detail >= SimCharacter::WEAPON_COUNT) break;
+            totals.kills[r.detail]++;
+            if (r.other < players && firstHitMs[p][r.other] >= 0) {
+                int64_t bucket = (r.elapsedMs - firstHitMs[p][r.other]) / TTK_BUCKET_MS;
+                totals.ttk[r.detail][std::min<int64_t>(std::max<int64_t>(bucket, 0), TTK_BUCKETS - 1)]++;
+            }
+            break;
+        case Telemetry::POSITION:
+            if (heatmap && r.x >= 0 && r.y >= 0 && r.x / HEATMAP_CELL < columns && r.y / HEATMAP_CELL < rows) {
+                (*heatmap)[static_cast<std::size_t>(r.y / HEATMAP_CELL) * columns + r.x / HEATMAP_CELL]++;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+bool TelemetryAnalytics::run(const Options& options, Totals& totals, std::string* error) {
+    std::vector<std::unique_ptr<MappedFile>> files;
+    std::vector<Range> ranges;
+    int threadCount = options.threads > 0 ? options.threads
+                                          : static_cast<int>(std::thread::hardware_concurrency());
+    if (threadCount <= 0) threadCount = 1;
+
+    std::vector<std::pair<const Telemetry::Record*, std::size_t>> logs;
+    std::size_t totalRecords = 0;
+    for (const std::string& path : options.inputs) {
+        std::unique_ptr<MappedFile> file(new MappedFile());
+        Telemetry::FileHeader header;
+        if (!file->open(path) || file->size() < sizeof(header)) {
+            if (error) *error = "无法读取 " + path;
+            return false;
+        }
+        std::memcpy(&header, file->data(), sizeof(header));
+        if (std::memcmp(header.magic, Telemetry::MAGIC, 4) != 0 || header.version < 1 || header.version > Telemetry::VERSION ||
+            header.recordSize != sizeof(Telemetry::Record)) {
+            if (error) *error = "不是遥测日志或版本不匹配: " + path;
+            return false;
+        }
+        // 文件末尾写了一半的记录忽略
+        std::size_t count = (file->size() - sizeof(header)) / sizeof(Telemetry::Record);
+        logs.push_back({reinterpret_cast<const Telemetry::Record*>(file->data() + sizeof(header)), count});
+        totalRecords += count;
+        files.push_back(std::move(file));
+    }
+
+    // 大文件按记录范围拆分，小文件各为一个任务
+    std::size_t rangeRecords = std::max(MIN_RANGE_RECORDS, totalRecords / (threadCount * RANGES_PER_THREAD) + 1);
+    for (const auto& log : logs) {
+        for (std::size_t begin = 0; begin < log.second; begin += rangeRecords) {
+            ranges.push_back({log.first, log.second, begin, std::min(begin + rangeRecords, log.second)});
+        }
+    }
+
+    // 任务从其范围内第一局的开头处理到下一个范围中第一局的开头；文件开头的任务从第0条开始
+    std::vector<Totals> partial(threadCount);
+    std::atomic<std::size_t> next{0};
+    auto worker = [&](int index) {
+        for (std::size_t i = next++; i < ranges.size(); i = next++) {
+            const Range& range = ranges[i];
+            std::size_t start = range.begin == 0 ? 0 : nextMatchStart(range.records, range.count, range.begin);
+            if (start >= range.end) continue;
+            std::size_t stop = nextMatchStart(range.records, range.count, range.end);
+            accumulate(range.records + start, stop - start, partial[index]);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 1; t < threadCount; t++) {
+        threads.emplace_back(worker, t);
+    }
+    worker(0);
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    for (const Totals& part : partial) totals.merge(part);
+    return true;
+}
+
+bool TelemetryAnalytics::writeReports(const Options& options, const Totals& totals) {
+    std::string dir = options.outputDir.empty() ? "." : options.outputDir;
+
+    std::ofstream weapons(dir + "/weapons.csv");
+    if (!weapons) return false;
+    weapons << "weapon,damage,kills,pickups,damage_per_pickup\n";
+    for (int w = 0; w < SimCharacter::WEAPON_COUNT; w++) {
+        weapons << WEAPON_NAMES[w] << "," << totals.damage[w] << "," << totals.kills[w] << ",";
+        int item = WEAPON_ITEMS[w];
+        if (item >= 0) {
+            weapons << totals.pickups[item] << ",";
+            if (totals.pickups[item] > 0) weapons << static_cast<double>(totals.damage[w]) / totals.pickups[item];
+        } else {
+            weapons << ",";
+        }
+        weapons << "\n";
+    }
+
+    std::ofstream items(dir + "/items.csv");
+    if (!items) return false;
+    items << "item,pickups,contested,contest_rate\n";
+    for (int t = 0; t < SimItem::TYPE_COUNT; t++) {
+        items << ITEM_NAMES[t] << "," << totals.pickups[t] << "," << totals.contested[t] << ",";
+        if (totals.pickups[t] > 0) items << static_cast<double>(totals.contested[t]) / totals.pickups[t];
+        items << "\n";
+    }
+
+    std::ofstream ttk(dir + "/ttk.csv");
+    if (!ttk) return false;
+    ttk << "ttk_ms";
+    for (const char* weapon : WEAPON_NAMES) ttk << "," << weapon;
+    ttk << ",all\n";
+    for (int b = 0; b < TTK_BUCKETS; b++) {
+        ttk << b * TTK_BUCKET_MS;
+        int64_t all = 0;
+        for (int w = 0; w < SimCharacter::WEAPON_COUNT; w++) {
+            ttk << "," << totals.ttk[w][b];
+            all += totals.ttk[w][b];
+        }
+        ttk << "," << all << "\n";
+    }
+
+    // 每种关卡尺寸一张图，与关卡同尺寸；能找到关卡时叠加平台轮廓
+    for (const auto& entry : totals.heatmaps) {
+        int width = entry.first.first;
+        int height = entry.first.second;
+        int columns = (width + HEATMAP_CELL - 1) / HEATMAP_CELL;
+        const std::vector<uint32_t>& cells = entry.second;
+        uint32_t peak = *std::max_element(cells.begin(), cells.end());
+        std::vector<uint8_t> rgb(static_cast<std::size_t>(width) * height * 3);
+        for (int py = 0; py < height; py++) {
+            for (int px = 0; px < width; px++) {
+                uint32_t value = cells[static_cast<std::size_t>(py / HEATMAP_CELL) * columns + px / HEATMAP_CELL];
+                uint8_t* pixel = &rgb[(static_cast<std::size_t>(py) * width + px) * 3];
+                if (value == 0) {
+                    pixel[0] = pixel[1] = pixel[2] = 16;
+                } else {
+                    heatColor(std::log1p(value) / std::log1p(peak), pixel);
+                }
+            }
+        }
+        std::vector<std::string> preferred;
+        if (!options.level.empty()) preferred.push_back(options.level);
+        auto logged = totals.levelNames.find(entry.first);
+        if (logged != totals.levelNames.end()) preferred.insert(preferred.end(), logged->second.begin(), logged->second.end());
+        if (std::shared_ptr<const Level> level = levelForArena(preferred, width, height)) {
+            for (const Platform& p : level->platforms) {
+                for (int py = std::max(0, p.y); py < std::min(height, p.y + p.height); py++) {
+                    for (int px = std::max(0, p.x); px < std::min(width, p.x + p.width); px++) {
+                        bool edge = py == p.y || py == p.y + p.height - 1 || px == p.x || px == p.x + p.width - 1;
+                        if (!edge) continue;
+                        uint8_t* pixel = &rgb[(static_cast<std::size_t>(py) * width + px) * 3];
+                        pixel[0] = pixel[1] = pixel[2] = 200;
+                    }
+                }
+            }
+        }
+        std::string path = dir + "/heatmap_" + std::to_string(width) + "x" + std::to_string(height) + ".png";
+        if (!writePng(path, width, height, rgb)) return false;
+    }
+    return true;
+}
+
+// 编码交给 QImage，统计部分仍不依赖Qt
+bool TelemetryAnalytics::writePng(const std::string& path, int width, int height, const std::vector<uint8_t>& rgb) {
+    QImage image(rgb.data(), width, height, width * 3, QImage::Format_RGB888);
+    return image.save(QString::fromStdString(path), "PNG");
+}
+
+int TelemetryAnalytics::main(int argc, char *argv[]) {
+    std::string executable = argv[0];
+    size_t slash = executable.find_last_of("/\\");
+    if (slash != std::string::npos) Level::addSearchPath(executable.substr(0, slash) + "/levels");
+
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (std::strcmp(arg, "--analyze") == 0) {
+            continue;
+        } else if (value && std::strcmp(arg, "--out-dir") == 0) {
+            options.outputDir = value; i++;
+        } else if (value && std::strcmp(arg, "--level") == 0) {
+            options.level = value; i++;
+        } else if (value && std::strcmp(arg, "--threads") == 0) {
+            options.threads = std::atoi(value); i++;
+        } else if (std::strncmp(arg, "--", 2) == 0) {
+            printUsage();
+            return 1;
+        } else {
+            options.inputs.push_back(arg);
+        }
+    }
+    if (options.inputs.empty()) {
+        printUsage();
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    Totals totals;
+    std::string error;
+    if (!run(options, totals, &error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (!writeReports(options, totals)) {
+        std::fprintf(stderr, "无法写入 %s\n", options.outputDir.c_str());
+        return 1;
+    }
+
+    double megabytes = totals.records * sizeof(Telemetry::Record) / 1e6;
+    std::printf("%zu 个文件  %llu 条记录（%.1f MB）  %llu 局  日志中丢弃 %llu 条\n",
+                options.inputs.size(), static_cast<unsigned long long>(totals.records), megabytes,
+                static_cast<unsigned long long>(totals.matches), static_cast<unsigned long long>(totals.dropped));
+    std::printf("统计耗时 %.3f 秒（%.0f MB/s）\n", seconds, seconds > 0 ? megabytes / seconds : 0.0);
+    return 0;
+}
@@ -0,0 +1,66 @@
+#ifndef TELEMETRY_ANALYTICS_H
+#define TELEMETRY_ANALYTICS_H
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Simulation.h"
+#include "Telemetry.h"
+
+// 遥测日志离线统计：把日志文件整体映射到内存，按文件和记录范围拆成任务分给工作线程，
+// 各线程单独累加后合并。范围边界对齐到 MATCH_START，同一局只由一个线程处理。
+// 输出位置热力图（PNG，与关卡同尺寸）、武器效率、道具争夺率和击杀耗时分布（CSV）。
+// 统计部分不依赖Qt，只有写PNG使用 QImage
+class TelemetryAnalytics {
+public:
+    static constexpr int HEATMAP_CELL = 8;          // 热力图每格边长（像素）
+    static constexpr int CONTEST_RADIUS = 200;      // 拾取时该范围内有其他存活玩家即视为争夺
+    static constexpr int TTK_BUCKET_MS = 250;       // 击杀耗时直方图每格
+    static constexpr int TTK_BUCKETS = 40;          // 最后一格统计所有超出范围的样本
+
+    struct Options {
+        std::vector<std::string> inputs;
+        std::string outputDir = ".";
+        std::string level;                          // 热力图上绘制的关卡，为空时用日志中记录的关卡名，再按尺寸匹配已知关卡
+        int threads = 0;                            // 0表示使用全部核心
+    };
+
+    // 一个工作线程（或全部线程合并后）的统计结果
+    struct Totals {
+        uint64_t records = 0;
+        uint64_t matches = 0;
+        uint64_t dropped = 0;                       // 日志中记录的丢弃数
+        int64_t damage[SimCharacter::WEAPON_COUNT] = {};
+        int64_t kills[SimCharacter::WEAPON_COUNT] = {};
+        int64_t pickups[SimItem::TYPE_COUNT] = {};
+        int64_t contested[SimItem::TYPE_COUNT] = {};
+        int64_t ttk[SimCharacter::WEAPON_COUNT][TTK_BUCKETS] = {};  // 按致命一击的武器
+        std::map<std::pair<int, int>, std::vector<uint32_t>> heatmaps; // 关卡尺寸 -> 各格位置采样数
+        std::map<std::pair<int, int>, std::set<std::string>> levelNames; // 关卡尺寸 -> 日志中记录的关卡名
+
+        void merge(const Totals& other);
+    };
+
+    // 命令行中是否包含 --analyze
+    static bool isAnalyticsInvocation(int argc, char *argv[]);
+
+    // 命令行入口，返回进程退出码
+    static int main(int argc, char *argv[]);
+
+    // 统计一段连续的记录（须从一局的开头或文件开头开始）
+    static void accumulate(const Telemetry::Record* records, std::size_t count, Totals& totals);
+
+    // 多线程统计全部文件；无法读取的文件写入 error 并返回 false
+    static bool run(const Options& options, Totals& totals, std::string* error = nullptr);
+
+    // 写出 weapons.csv、items.csv、ttk.csv 和 heatmap_<宽>x<高>.png
+    static bool writeReports(const Options& options, const Totals& totals);
+
+    // 8位RGB图片写为PNG（QImage 编码）
+    static bool writePng(const std::string& path, int width, int height, const std::vector<uint8_t>& rgb);
+};
+
+#endif // TELEMETRY_ANALYTICS_H
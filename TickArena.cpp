@@ -0,0 +1,98 @@
+#include "TickArena.h"
+#include "HeapCounter.h"
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+TickArena::TickArena(std::size_t blockBytes) {
+    addBlock(blockBytes);
+}
+
+TickArena::~TickArena() {
+    releaseBlocks();
+}
+
+std::size_t TickArena::capacity() const {
+    std::size_t bytes = 0;
+    for (const Block& block : blocks) bytes += block.size;
+    return bytes;
+}
+
+void TickArena::addBlock(std::size_t minBytes) {
+    std::size_t size = std::max(minBytes, blocks.empty() ? std::size_t(0) : blocks.back().size * 2);
+    blocks.push_back({ static_cast<char*>(std::malloc(size)), size });
+    if (!blocks.back().data) {
+        blocks.pop_back();
+        throw std::bad_alloc();
+    }
+}
+
+void TickArena::releaseBlocks() {
+    for (const Block& block : blocks) std::free(block.data);
+    blocks.clear();
+}
+
+void* TickArena::do_allocate(std::size_t bytes, std::size_t alignment) {
+    for (;;) {
+        Block& block = blocks[current];
+        uintptr_t base = reinterpret_cast<uintptr_t>(block.data);
+        uintptr_t aligned = (base + offset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+        std::size_t end = aligned - base + bytes;
+        if (end <= block.size) {
+            used += end - offset;
+            offset = end;
+            total += bytes;
+            peak = std::max(peak, used);
+            outstanding++;
+            return reinterpret_cast<void*>(aligned);
+        }
+        // 当前块放不下：换到下一块（上次合并前留下的或新申请的）
+        used += block.size - offset;
+        if (current + 1 == blocks.size()) addBlock(bytes + alignment);
+        current++;
+        offset = 0;
+    }
+}
+
+void TickArena::do_deallocate(void*, std::size_t, std::size_t) {
+    outstanding--;
+}
+
+void TickArena::reset() {
+    if (outstanding > 0) {
+        deferred++;
+        return;
+    }
+    if (current > 0) {
+        // 本帧用到了多个块：合并成一块，以后的帧只用这一块
+        std::size_t merged = capacity();
+        releaseBlocks();
+        addBlock(merged);
+    }
+    current = 0;
+    offset = 0;
+    used = 0;
+}
+
+bool AllocationMeter::countsHeap() {
+    return HeapCounter::enabled();
+}
+
+void AllocationMeter::begin(const TickArena& arena) {
+    startArena = arena.totalBytes();
+    startHeap = HeapCounter::threadBytes();
+    startAllocations = HeapCounter::threadAllocations();
+}
+
+void AllocationMeter::end(const TickArena& arena) {
+    sumArena += arena.totalBytes() - startArena;
+    sumHeap += HeapCounter::threadBytes() - startHeap;
+    sumAllocations += HeapCounter::threadAllocations() - startAllocations;
+    if (++samples < WINDOW) return;
+
+    averageArenaBytes = static_cast<double>(sumArena) / samples;
+    averageHeapBytes = static_cast<double>(sumHeap) / samples;
+    averageHeapAllocations = static_cast<double>(sumAllocations) / samples;
+    sumArena = sumHeap = sumAllocations = 0;
+    samples = 0;
+}
@@ -0,0 +1,85 @@
+#ifndef TICK_ARENA_H
+#define TICK_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+// 帧内临时数据的线性分配器：分配只移动指针，释放只计数，每个模拟帧（或显示帧）结束时整体回到起点。
+// 可作为 std::pmr 容器的内存来源，例如 std::pmr::vector<int> ids(&arena)。
+// 一帧内用完当前块时向堆申请更大的块，下次重置时合并成一块，之后的帧不再申请。
+// 不是线程安全的，每个线程（推演工作线程、界面线程）各用一个
+class TickArena : public std::pmr::memory_resource {
+public:
+    static constexpr std::size_t DEFAULT_BLOCK_BYTES = 64 * 1024;
+
+    explicit TickArena(std::size_t blockBytes = DEFAULT_BLOCK_BYTES);
+    ~TickArena() override;
+
+    TickArena(const TickArena&) = delete;
+    TickArena& operator=(const TickArena&) = delete;
+
+    // 帧结束：所有分配都已归还时回到起点，仍有容器存活时推迟到下一次
+    void reset();
+
+    std::size_t usedBytes() const { return used; }        // 自上次重置以来分配的字节
+    std::size_t peakBytes() const { return peak; }        // 两次重置之间的最大用量
+    std::size_t capacity() const;                         // 已向堆申请的字节
+    uint64_t totalBytes() const { return total; }         // 累计分配的字节
+    uint64_t deferredResets() const { return deferred; }  // 因容器未释放而推迟的重置次数
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+    struct Block {
+        char* data;
+        std::size_t size;
+    };
+
+    void addBlock(std::size_t minBytes);
+    void releaseBlocks();
+
+    std::vector<Block> blocks;
+    std::size_t current = 0;    // 正在使用的块
+    std::size_t offset = 0;     // 当前块内已用的字节
+    std::size_t used = 0;
+    std::size_t peak = 0;
+    uint64_t total = 0;
+    uint64_t deferred = 0;
+    int outstanding = 0;        // 尚未归还的分配
+};
+
+// 统计一段代码期间经过 arena 和全局堆（HeapCounter）的字节数，每 WINDOW 次取一次平均
+class AllocationMeter {
+public:
+    static constexpr int WINDOW = 60;
+
+    // 未启用 HeapCounter 的构建中堆的统计恒为0，显示为 n/a
+    static bool countsHeap();
+
+    void begin(const TickArena& arena);
+    void end(const TickArena& arena);
+
+    // 最近一个完整窗口内每次的平均值
+    double arenaBytes() const { return averageArenaBytes; }
+    double heapBytes() const { return averageHeapBytes; }
+    double heapAllocations() const { return averageHeapAllocations; }
+
+private:
+    uint64_t startArena = 0;
+    uint64_t startHeap = 0;
+    uint64_t startAllocations = 0;
+    uint64_t sumArena = 0;
+    uint64_t sumHeap = 0;
+    uint64_t sumAllocations = 0;
+    int samples = 0;
+    double averageArenaBytes = 0.0;
+    double averageHeapBytes = 0.0;
+    double averageHeapAllocations = 0.0;
+};
+
+#endif // TICK_ARENA_H
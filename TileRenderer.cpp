@@ -0,0 +1,112 @@
+#include "TileRenderer.h"
+#include <QElapsedTimer>
+#include <QPainter>
+#include <QThread>
+#include <atomic>
+
+TileRenderer::Command TileRenderer::Command::draw(int x, int y, const QImage &image) {
+    Command command;
+    command.target = QRect(x, y, image.width(), image.height());
+    command.image = image;
+    return command;
+}
+
+TileRenderer::Command TileRenderer::Command::fill(const QRect &rect, const QColor &color) {
+    Command command;
+    command.target = rect;
+    command.color = color;
+    return command;
+}
+
+TileRenderer::TileRenderer() {
+    setThreadCount(QThread::idealThreadCount());
+}
+
+TileRenderer::~TileRenderer() {
+    pool.waitForDone();
+}
+
+void TileRenderer::setThreadCount(int count) {
+    threads = qMax(1, count);
+    pool.setMaxThreadCount(qMax(1, threads - 1));
+}
+
+void TileRenderer::render(const QVector<Command> &commands, QImage &target) {
+    QElapsedTimer wallTimer;
+    wallTimer.start();
+
+    // 图块网格和分组：只在窗口尺寸变化时重新分配
+    int columns = (target.width() + TILE_SIZE - 1) / TILE_SIZE;
+    int rows = (target.height() + TILE_SIZE - 1) / TILE_SIZE;
+    int count = columns * rows;
+    tileStats.resize(count);
+    bins.resize(count);
+    for (int row = 0; row < rows; row++) {
+        for (int column = 0; column < columns; column++) {
+            Tile &tile = tileStats[row * columns + column];
+            tile.rect = QRect(column * TILE_SIZE, row * TILE_SIZE, TILE_SIZE, TILE_SIZE).intersected(target.rect());
+            bins[row * columns + column].clear();
+        }
+    }
+    for (int i = 0; i < commands.size(); i++) {
+        const QRect &area = commands[i].target;
+        int firstColumn = qMax(0, area.left() / TILE_SIZE);
+        int lastColumn = qMin(columns - 1, area.right() / TILE_SIZE);
+        int firstRow = qMax(0, area.top() / TILE_SIZE);
+        int lastRow = qMin(rows - 1, area.bottom() / TILE_SIZE);
+        for (int row = firstRow; row <= lastRow; row++) {
+            for (int column = firstColumn; column <= lastColumn; column++) bins[row * columns + column].append(i);
+        }
+    }
+
+    // 各线程从同一个计数器领取图块，界面线程也参与，结束后等待其余线程
+    uchar *bits = target.bits();
+    int bytesPerLine = target.bytesPerLine();
+    QImage::Format format = target.format();
+    std::atomic<int> next{0};
+    auto work = [&](int worker) {
+        for (int index; (index = next.fetch_add(1, std::memory_order_relaxed)) < count;) {
+            renderTile(index, worker, commands, bits, bytesPerLine, format);
+        }
+    };
+    int helpers = qMin(threads - 1, count - 1);
+    for (int worker = 1; worker <= helpers; worker++) {
+        pool.start([&work, worker]() { work(worker); });
+    }
+    work(0);
+    pool.waitForDone();
+
+    lastTileSumNs = 0;
+    for (const Tile &tile : tileStats) lastTileSumNs += tile.ns;
+    lastWallNs = wallTimer.nsecsElapsed();
+}
+
+// 把后台缓冲中图块所在的区域包装成独立的 QImage（共享同一块内存，不复制），
+// 每个线程用自己的 QPainter 绘制
+void TileRenderer::renderTile(int index, int worker, const QVector<Command> &commands, uchar *bits,
+                              int bytesPerLine, QImage::Format format) {
+    QElapsedTimer timer;
+    timer.start();
+    Tile &tile = tileStats[index];
+    const QRect &rect = tile.rect;
+    QImage view(bits + rect.y() * bytesPerLine + rect.x() * 4, rect.width(), rect.height(), bytesPerLine, format);
+
+    QPainter painter(&view);
+    for (int i : bins[index]) {
+        const Command &command = commands[i];
+        QRect visible = command.target.intersected(rect);
+        if (visible.isEmpty()) continue;
+        if (command.image.isNull()) {
+            painter.fillRect(visible.translated(-rect.x(), -rect.y()), command.color);
+        } else {
+            painter.drawImage(visible.x() - rect.x(), visible.y() - rect.y(), command.image,
+                              visible.x() - command.target.x(), visible.y() - command.target.y(),
+                              visible.width(), visible.height());
+        }
+    }
+    painter.end();
+
+    tile.commands = bins[index].size();
+    tile.worker = worker;
+    tile.ns = timer.nsecsElapsed();
+}
@@ -0,0 +1,61 @@
+#ifndef TILE_RENDERER_H
+#define TILE_RENDERER_H
+
+#include <QImage>
+#include <QColor>
+#include <QRect>
+#include <QVector>
+#include <QThreadPool>
+
+// 分块并行光栅化：把一帧的绘制列表按屏幕图块分组，工作线程各自把图块绘制到共享后台缓冲
+// （QImage）中互不重叠的区域，全部完成后由界面线程整体显示。
+// 只能使用 QImage（QPixmap 不能离开界面线程），后台缓冲须为32位格式
+class TileRenderer {
+public:
+    static constexpr int TILE_SIZE = 128;   // 图块边长（像素）
+
+    // 绘制命令：把图片原样画到 target 左上角，图片为空时用 color 填充 target
+    struct Command {
+        QRect target;
+        QImage image;
+        QColor color;
+
+        static Command draw(int x, int y, const QImage &image);
+        static Command fill(const QRect &rect, const QColor &color);
+    };
+
+    // 最近一次绘制中每个图块的统计
+    struct Tile {
+        QRect rect;
+        int commands = 0;       // 与图块相交的命令数
+        int worker = 0;         // 绘制该图块的线程（0为界面线程）
+        qint64 ns = 0;          // 绘制耗时
+    };
+
+    TileRenderer();
+    ~TileRenderer();
+
+    // 参与绘制的线程数（含界面线程），1 表示只在界面线程绘制
+    void setThreadCount(int threads);
+    int threadCount() const { return threads; }
+
+    // 按顺序执行绘制命令，阻塞到所有图块完成
+    void render(const QVector<Command> &commands, QImage &target);
+
+    const QVector<Tile>& tiles() const { return tileStats; }
+    qint64 wallNs() const { return lastWallNs; }        // 最近一次绘制的总耗时
+    qint64 tileSumNs() const { return lastTileSumNs; }  // 各图块耗时之和（约等于单线程绘制的耗时）
+
+private:
+    void renderTile(int index, int worker, const QVector<Command> &commands, uchar *bits,
+                    int bytesPerLine, QImage::Format format);
+
+    QThreadPool pool;
+    int threads = 1;
+    QVector<Tile> tileStats;
+    QVector<QVector<int>> bins;     // 每个图块相交的命令下标（按绘制顺序）
+    qint64 lastWallNs = 0;
+    qint64 lastTileSumNs = 0;
+};
+
+#endif // TILE_RENDERER_H
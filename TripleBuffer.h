@@ -0,0 +1,42 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+
+// 三重缓冲：写线程在后台槽写完一份完整数据后发布，读线程随时切换到最新发布的一份。
+// 双方都不等待对方；读线程来不及读取的中间结果直接被覆盖。
+// 读线程持有的槽在下一次 update 之前不会被写线程改动
+template <class T>
+class TripleBuffer {
+public:
+    // 写线程：可写的槽
+    T& writeBuffer() { return buffers[backIndex]; }
+
+    // 写线程：发布刚写完的槽，换回上一个未被读取（或已读完）的槽继续写
+    void publish() {
+        int previous = middle.exchange(backIndex | FRESH, std::memory_order_acq_rel);
+        backIndex = previous & INDEX_MASK;
+    }
+
+    // 读线程：有新发布的数据时切换过去，返回是否切换
+    bool update() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) return false;
+        int previous = middle.exchange(frontIndex, std::memory_order_acq_rel);
+        frontIndex = previous & INDEX_MASK;
+        return true;
+    }
+
+    // 读线程：当前读取的槽
+    const T& readBuffer() const { return buffers[frontIndex]; }
+
+private:
+    static constexpr int INDEX_MASK = 3;
+    static constexpr int FRESH = 4;   // 中间槽是否为尚未读取的新数据
+
+    T buffers[3];
+    std::atomic<int> middle{1};       // 中间槽的下标和 FRESH 标记
+    int backIndex = 0;                // 只由写线程访问
+    int frontIndex = 2;               // 只由读线程访问
+};
+
+#endif // TRIPLE_BUFFER_H
@@ -4,12 +4,101 @@
 #include <QLabel>
 #include <QPushButton>
 #include <QPixmap>
+#include <QTimer>
+#include <QDebug>
+#include <QFile>
 #include "GameScreen.h"
 #include "GameOverScreen.h"
 #include "HelpScreen.h"
+#include "BatchRunner.h"
+#include "StressTest.h"
+#include "TelemetryAnalytics.h"
+#include "MemoryStats.h"
 
 int main(int argc, char *argv[]) {
+    // 无界面批量对战模式（不创建窗口）
+    if (BatchRunner::isBatchInvocation(argc, argv)) {
+        return BatchRunner::main(argc, argv);
+    }
+    if (StressTest::isHeadlessInvocation(argc, argv)) {
+        return StressTest::main(argc, argv);
+    }
+    if (TelemetryAnalytics::isAnalyticsInvocation(argc, argv)) {
+        return TelemetryAnalytics::main(argc, argv);
+    }
+
     QApplication app(argc, argv);
+    Level::addSearchPath((QCoreApplication::applicationDirPath() + "/levels").toStdString());
+
+    // 显示刷新率：--fps N（默认60，与模拟频率无关）；关卡：--level classic|wide；
+    // 人数：--players 2-8，--teams N（0为各自为战），--humans 0-3（其余玩家由电脑控制）；
+    // 模拟频率：--sim-hz 20-240（默认62.5，物理结果与频率无关）；
+    // 内存统计：--memory-dump memory.jsonl，每 --memory-interval 秒（默认10）追加一行；
+    // 继续上次对战：--resume（点击开始后读取快速存档，人数须与本次设置一致）；
+    // 遥测日志：--telemetry telemetry.bin（伤害、恢复、拾取、换武器、倒下和每秒位置，超过64MB轮换）
+    int displayRate = GameScreen::DEFAULT_DISPLAY_RATE;
+    std::shared_ptr<const Level> level = Level::classic();
+    MatchSetup setup;
+    QString memoryDumpPath;
+    int memoryIntervalSec = 10;
+    QString telemetryPath;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (QString(argv[i]) == "--fps") displayRate = QString(argv[i + 1]).toInt();
+        if (QString(argv[i]) == "--level" && Level::byName(argv[i + 1])) level = Level::byName(argv[i + 1]);
+        if (QString(argv[i]) == "--players") setup.players = QString(argv[i + 1]).toInt();
+        if (QString(argv[i]) == "--teams") setup.teams = QString(argv[i + 1]).toInt();
+        if (QString(argv[i]) == "--humans") setup.humans = QString(argv[i + 1]).toInt();
+        if (QString(argv[i]) == "--sim-hz") setup.tickHz = QString(argv[i + 1]).toInt();
+        if (QString(argv[i]) == "--memory-dump") memoryDumpPath = argv[i + 1];
+        if (QString(argv[i]) == "--memory-interval") memoryIntervalSec = QString(argv[i + 1]).toInt();
+        if (QString(argv[i]) == "--telemetry") telemetryPath = argv[i + 1];
+    }
+    bool resume = false;
+    for (int i = 1; i < argc; i++) {
+        if (QString(argv[i]) == "--resume") resume = true;
+    }
+
+    // 定期转储覆盖整个进程（跨越多局对战），因此挂在应用对象上
+    if (!memoryDumpPath.isEmpty() && memoryIntervalSec > 0) {
+        QTimer *memoryDumpTimer = new QTimer(&app);
+        QObject::connect(memoryDumpTimer, &QTimer::timeout, [memoryDumpPath, memoryDumpTimer]() {
+            if (!MemoryStats::collect().appendTo(memoryDumpPath)) {
+                qWarning() << "无法写入内存统计:" << memoryDumpPath;
+                memoryDumpTimer->stop();
+            }
+        });
+        memoryDumpTimer->start(memoryIntervalSec * 1000);
+    }
+
+    // 遥测日志同样跨越多局对战，须比所有游戏界面存活更久
+    std::unique_ptr<Telemetry> telemetry;
+    if (!telemetryPath.isEmpty()) {
+        Telemetry::Options telemetryOptions;
+        telemetryOptions.path = telemetryPath.toStdString();
+        telemetry.reset(new Telemetry());
+        if (!telemetry->start(telemetryOptions)) {
+            qWarning() << "无法写入遥测日志:" << telemetryPath;
+            telemetry.reset();
+        }
+    }
+
+    // 窗口压力测试：单独的游戏界面，全部8个角色由加压过程控制人数，结束后退出
+    if (StressTest::isStressInvocation(argc, argv)) {
+        StressTest::Options stressOptions;
+        if (!StressTest::parseOptions(argc, argv, stressOptions)) return 1;
+        MatchSetup stressSetup;
+        stressSetup.players = SimWorld::MAX_PLAYERS;
+        stressSetup.humans = 0;
+        GameScreen stressScreen(stressSetup);
+        stressScreen.setWindowTitle("2D横版射击游戏 - 压力测试");
+        stressScreen.resize(1200, 800);
+        stressScreen.setBackground(QPixmap(":/new/prefix1/res/background.jpg"));
+        stressScreen.setDisplayRate(displayRate);
+        stressScreen.show();
+        stressScreen.startStress(stressOptions);
+        QObject::connect(&stressScreen, &GameScreen::stressFinished, &app, &QCoreApplication::quit);
+        return app.exec();
+    }
 
     // 创建主窗口
     QMainWindow mainWindow;
@@ -78,7 +167,10 @@ int main(int argc, char *argv[]) {
     startLayout->addWidget(buttonContainer, 0, Qt::AlignCenter);
 
     // 2. 游戏界面
-    GameScreen *gameScreen = new GameScreen();
+    GameScreen *gameScreen = new GameScreen(setup);
+    gameScreen->setDisplayRate(displayRate);
+    gameScreen->setTelemetry(telemetry.get());
+    gameScreen->loadLevel(level);
     if (!backgroundPixmap.isNull()) {
         gameScreen->setBackground(backgroundPixmap);
     }
@@ -99,7 +191,9 @@ int main(int argc, char *argv[]) {
     QObject::connect(startButton, &QPushButton::clicked, [&]() {
         stackedWidget->setCurrentIndex(1);
         gameScreen->setFocus();
-        gameScreen->startSpawningItems();
+        // 只在第一局读档
+        gameScreen->startMatch(resume && QFile::exists(GameScreen::QUICKSAVE_FILE));
+        resume = false;
     });
 
     QObject::connect(helpButton, &QPushButton::clicked, [&]() {
@@ -107,7 +201,7 @@ int main(int argc, char *argv[]) {
     });
 
     QObject::connect(gameScreen, &GameScreen::gameOver, [&](int winner) {
-        gameOverScreen->setWinner(winner);
+        gameOverScreen->setWinner(winner, gameScreen->isTeamMatch());
         stackedWidget->setCurrentIndex(2);
     });
 
@@ -115,13 +209,16 @@ int main(int argc, char *argv[]) {
         stackedWidget->setCurrentIndex(0);
         stackedWidget->removeWidget(gameScreen);
         delete gameScreen;
-        gameScreen = new GameScreen();
+        gameScreen = new GameScreen(setup);
+        gameScreen->setDisplayRate(displayRate);
+        gameScreen->setTelemetry(telemetry.get());
+        gameScreen->loadLevel(level);
         if (!backgroundPixmap.isNull()) {
             gameScreen->setBackground(backgroundPixmap);
         }
         stackedWidget->insertWidget(1, gameScreen);
         QObject::connect(gameScreen, &GameScreen::gameOver, [&](int winner) {
-            gameOverScreen->setWinner(winner);
+            gameOverScreen->setWinner(winner, gameScreen->isTeamMatch());
             stackedWidget->setCurrentIndex(2);
         });
     });
@@ -0,0 +1,210 @@
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "BatchRunner.h"
+#include "InputState.h"
+#include "MatchSnapshot.h"
+#include "Simulation.h"
+
+// 极简测试框架：每个用例是一个函数，CHECK 失败时打印位置并记为失败
+namespace {
+int failures = 0;
+
+#define CHECK(condition)                                                          \
+    do {                                                                          \
+        if (!(condition)) {                                                       \
+            std::fprintf(stderr, "%s:%d: 检查失败: %s\n", __FILE__, __LINE__, #condition); \
+            failures++;                                                           \
+        }                                                                         \
+    } while (0)
+
+// 两名玩家面对面站在标准竞技场的地面上，间隔 gap 像素
+void placeFacing(SimWorld& world, int gap) {
+    SimCharacter& a = world.characters[0];
+    SimCharacter& b = world.characters[1];
+    b.x = a.x + a.width + gap;
+    b.y = a.y;
+    a.facingRight = true;
+    b.facingRight = false;
+}
+
+// 连按攻击（隔帧按下）时出招不会被打断，拳头仍能命中
+void testMashingAttackLandsDamage() {
+    SimWorld world;
+    world.reset(7, Level::classic(), 2, 0);
+    placeFacing(world, 10);
+
+    InputState inputs[2];
+    TickInput tick[2];
+    for (int i = 0; i < 180 && world.characters[1].health == 100; i++) {
+        inputs[0].setHeld(i % 2 == 0 ? INPUT_ATTACK : 0);
+        tick[0] = inputs[0].sample();
+        tick[1] = inputs[1].sample();
+        world.step(tick);
+    }
+    CHECK(world.characters[1].health < 100);
+    CHECK(world.stats[0].damageByWeapon[SimCharacter::FIST] > 0);
+}
+
+// 出招中的按键留在缓冲里，招式结束后自动出下一招
+void testAttackDuringSwingIsBuffered() {
+    SimWorld world;
+    world.reset(7, Level::classic(), 2, 0);
+    placeFacing(world, 10);
+
+    TickInput press[2];
+    press[0].held = press[0].pressed = INPUT_ATTACK;
+    TickInput idle[2];
+    world.step(press);
+    int duration = world.characters[0].meleeRemainingMs;
+    CHECK(duration > 0);
+
+    // 招式结束前不到一个缓冲时长时再按一次
+    while (world.characters[0].meleeRemainingMs > SimWorld::INPUT_BUFFER_MS / 2) world.step(idle);
+    int before = world.characters[0].meleeRemainingMs;
+    world.step(press);
+    CHECK(world.characters[0].meleeRemainingMs < before);
+    for (int i = 0; i < 10 && world.characters[0].meleeRemainingMs <= before; i++) world.step(idle);
+    CHECK(world.characters[0].meleeRemainingMs > before);
+}
+
+// 脚本策略不对称：批量对战中会拾取道具，胜负也不全是同时倒下
+void testScriptedBatchPicksUpItems() {
+    BatchRunner::Options options;
+    options.matches = 40;
+    options.seed = 7;
+    options.threads = 2;
+    std::vector<BatchRunner::MatchResult> results = BatchRunner::run(options);
+    CHECK(results.size() == 40u);
+
+    int pickups = 0;
+    int decided = 0;
+    for (const BatchRunner::MatchResult& result : results) {
+        for (int p = 0; p < result.players; p++) {
+            for (int count : result.stats[p].itemsPickedUp) pickups += count;
+        }
+        if (result.winner != 0) decided++;
+    }
+    CHECK(pickups > 0);
+    CHECK(decided > 0);
+}
+
+// 推进若干帧：每名玩家走向最近的对手，靠近后攻击。输入只取决于世界状态，同样的世界得到同样的输入
+void playFor(SimWorld& world, int ticks) {
+    TickInput input[SimWorld::MAX_PLAYERS] = {};
+    for (int t = 0; t < ticks && !world.isOver(); t++) {
+        for (int i = 0; i < world.playerCount; i++) {
+            const SimCharacter& self = world.characters[i];
+            int enemy = world.nearestEnemy(i);
+            uint8_t held = 0;
+            if (enemy >= 0) {
+                const SimCharacter& target = world.characters[enemy];
+                held |= target.x < self.x ? INPUT_LEFT : INPUT_RIGHT;
+                if (std::abs(target.x - self.x) < 150 && world.tick % 3 == 0) held |= INPUT_ATTACK;
+                if (target.y + target.height < self.y && world.tick % 40 == 0) held |= INPUT_JUMP;
+            }
+            input[i].pressed = held & ~input[i].held;
+            input[i].held = held;
+        }
+        world.step(input);
+    }
+}
+
+bool sameWorld(const SimWorld& a, const SimWorld& b) {
+    if (a.tick != b.tick || a.elapsedMs != b.elapsedMs || a.rng.state != b.rng.state ||
+        a.items.size() != b.items.size() || a.projectiles.size() != b.projectiles.size()) {
+        return false;
+    }
+    for (int i = 0; i < a.playerCount; i++) {
+        const SimCharacter& x = a.characters[i];
+        const SimCharacter& y = b.characters[i];
+        if (x.x != y.x || x.y != y.y || x.health != y.health || x.weapon != y.weapon) return false;
+    }
+    return true;
+}
+
+std::vector<char> snapshotOf(const SimWorld& world) {
+    std::vector<char> data(MatchSnapshot::size(world));
+    MatchSnapshot::write(world, data.data());
+    return data;
+}
+
+// 存档后恢复到另一个世界，两边继续推进结果一致（包括道具生成计时）
+void testSnapshotRoundTrip() {
+    SimWorld world;
+    world.reset(11, Level::classic(), 4, 0);
+    world.startSpawning();
+    playFor(world, 2400);
+    CHECK(!world.items.empty() || !world.projectiles.empty());
+    std::vector<char> data = snapshotOf(world);
+
+    SimWorld restored;
+    restored.reset(99, Level::classic(), 2, 0);
+    std::string error;
+    CHECK(MatchSnapshot::restore(data.data(), data.size(), restored, &error));
+    CHECK(error.empty());
+    CHECK(sameWorld(world, restored));
+    CHECK(restored.spawning == world.spawning);
+    for (int t = 0; t < SimItem::TYPE_COUNT; t++) CHECK(restored.spawnRemainingMs[t] == world.spawnRemainingMs[t]);
+
+    playFor(world, 1200);
+    playFor(restored, 1200);
+    CHECK(sameWorld(world, restored));
+}
+
+// 截断或字段被改坏的存档被拒绝，世界保持原样
+void testSnapshotRejectsDamagedFiles() {
+    SimWorld world;
+    world.reset(11, Level::classic(), 4, 0);
+    world.startSpawning();
+    playFor(world, 2400);
+    std::vector<char> data = snapshotOf(world);
+
+    SimWorld target;
+    target.reset(5, Level::classic(), 2, 0);
+    playFor(target, 60);
+    const SimWorld before = target;
+
+    std::size_t lengths[] = { 0, sizeof(MatchSnapshot::Header) - 1, sizeof(MatchSnapshot::Header), data.size() - 1 };
+    for (std::size_t length : lengths) {
+        std::string error;
+        CHECK(!MatchSnapshot::restore(data.data(), length, target, &error));
+        CHECK(!error.empty());
+        CHECK(sameWorld(before, target));
+    }
+
+    // 第一名角色的武器、队伍、生命依次改成越界值
+    std::size_t character = sizeof(MatchSnapshot::Header);
+    std::size_t fields[] = { offsetof(SimCharacter, weapon), offsetof(SimCharacter, team), offsetof(SimCharacter, health) };
+    for (std::size_t field : fields) {
+        std::vector<char> damaged = data;
+        int invalid = -1;
+        std::memcpy(damaged.data() + character + field, &invalid, sizeof(invalid));
+        CHECK(!MatchSnapshot::restore(damaged.data(), damaged.size(), target));
+        CHECK(sameWorld(before, target));
+    }
+
+    std::vector<char> renamed = data;
+    std::memcpy(renamed.data() + offsetof(MatchSnapshot::Header, level), "no-such-level", 14);
+    CHECK(!MatchSnapshot::restore(renamed.data(), renamed.size(), target));
+    CHECK(sameWorld(before, target));
+}
+}
+
+int main() {
+    testMashingAttackLandsDamage();
+    testAttackDuringSwingIsBuffered();
+    testScriptedBatchPicksUpItems();
+    testSnapshotRoundTrip();
+    testSnapshotRejectsDamagedFiles();
+
+    if (failures > 0) {
+        std::fprintf(stderr, "%d 项检查失败\n", failures);
+        return EXIT_FAILURE;
+    }
+    std::printf("全部通过\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,22 @@
+# 模拟层的自动测试（不依赖Qt）：qmake tests.pro && make && ./tests
+TEMPLATE = app
+TARGET = tests
+
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+INCLUDEPATH += ..
+
+SOURCES += \
+    SimulationTests.cpp \
+    ../BatchRunner.cpp \
+    ../BotSearch.cpp \
+    ../HeapCounter.cpp \
+    ../HitTest.cpp \
+    ../LatencyProbe.cpp \
+    ../Level.cpp \
+    ../MatchSnapshot.cpp \
+    ../Simulation.cpp \
+    ../TickArena.cpp
+
+unix: LIBS += -pthread
@@ -0,0 +1,173 @@
+#!/usr/bin/env python3
+# 关卡编译器：把文本关卡描述（.lvl）编译为游戏直接载入的二进制（.lvb）
+# 用法: levelc.py input.lvl output.lvb
+#
+# 文本格式（每行一条，# 开头为注释）：
+#   name <名称>
+#   size <宽> <高>                         高度即跌落复活线
+#   platform <x> <y> <宽> <高> normal|grass|ice
+#   decoration grass|snow <x> <y> <宽> <高>
+#   spawn <x> <脚底y>                      玩家出生点，按顺序分配
+#   respawn <x> <y>                        跌落复活点
+#   items <最小x> <最大x>                  道具生成的水平范围
+#   item <道具> <间隔毫秒>                 道具生成间隔，0表示不生成
+#
+# 二进制格式与 Level::BinaryHeader 一致（小端，4字节对齐）
+
+import struct
+import sys
+
+CHUNK_WIDTH = 600  # 与 Level::CHUNK_WIDTH 一致
+MAGIC = b'LVB1'
+VERSION = 1
+
+TERRAIN = {'normal': 0, 'grass': 1, 'ice': 2}
+DECORATION = {'grass': 0, 'snow': 1}
+ITEMS = ['bandage', 'medkit', 'adrenaline', 'knife', 'ball', 'rifle', 'sniper', 'light_armor', 'bulletproof_vest']
+DEFAULT_INTERVALS = [20000, 30000, 60000, 45000, 60000, 70000, 90000, 55000, 65000]
+
+# 文件头字段（顺序与 Level::BinaryHeader 一致）
+HEADER_FORMAT = '<4sIII' + 'ii' + 'ii' + 'i' * len(ITEMS) + 'i' + 'II' * 5 + 'I' + 'I' + 'II' + 'I' + 'II'
+
+
+class LevelError(Exception):
+    pass
+
+
+def parse(path):
+    level = {
+        'name': None, 'width': None, 'height': None,
+        'platforms': [], 'decorations': [], 'spawns': [], 'respawns': [],
+        'item_range': None, 'intervals': list(DEFAULT_INTERVALS),
+    }
+    with open(path, encoding='utf-8') as f:
+        for number, raw in enumerate(f, 1):
+            line = raw.split('#', 1)[0].strip()
+            if not line:
+                continue
+            words = line.split()
+            key, args = words[0], words[1:]
+            try:
+                if key == 'name' and len(args) == 1:
+                    level['name'] = args[0]
+                elif key == 'size' and len(args) == 2:
+                    level['width'], level['height'] = int(args[0]), int(args[1])
+                elif key == 'platform' and len(args) == 5:
+                    level['platforms'].append([int(a) for a in args[:4]] + [TERRAIN[args[4]]])
+                elif key == 'decoration' and len(args) == 5:
+                    level['decorations'].append([int(a) for a in args[1:]] + [DECORATION[args[0]]])
+                elif key == 'spawn' and len(args) == 2:
+                    level['spawns'].append([int(args[0]), int(args[1])])
+                elif key == 'respawn' and len(args) == 2:
+                    level['respawns'].append([int(args[0]), int(args[1])])
+                elif key == 'items' and len(args) == 2:
+                    level['item_range'] = (int(args[0]), int(args[1]))
+                elif key == 'item' and len(args) == 2:
+                    level['intervals'][ITEMS.index(args[0])] = int(args[1])
+                else:
+                    raise LevelError('无法识别的行')
+            except (ValueError, KeyError) as e:
+                raise LevelError('%s:%d: 参数无效 (%s)' % (path, number, e))
+            except LevelError as e:
+                raise LevelError('%s:%d: %s' % (path, number, e))
+
+    if not level['name'] or level['width'] is None:
+        raise LevelError('%s: 缺少 name 或 size' % path)
+    if level['width'] <= 0 or level['height'] <= 0:
+        raise LevelError('%s: 关卡尺寸无效' % path)
+    if not level['spawns']:
+        raise LevelError('%s: 至少需要一个出生点' % path)
+    if level['item_range'] is None:
+        level['item_range'] = (100, level['width'] - 200)
+    if level['item_range'][0] >= level['item_range'][1]:
+        raise LevelError('%s: 道具生成范围无效' % path)
+    return level
+
+
+def chunk_at(x, count):
+    # 与 Level::chunkAt 一致：向零取整后限制在有效区块内
+    chunk = int(x / CHUNK_WIDTH)
+    return max(0, min(chunk, count - 1))
+
+
+def build_chunks(level):
+    count = max(1, (level['width'] + CHUNK_WIDTH - 1) // CHUNK_WIDTH)
+    platform_lists = [[] for _ in range(count)]
+    decoration_lists = [[] for _ in range(count)]
+    for i, (x, _, w, _, _) in enumerate(level['platforms']):
+        for c in range(chunk_at(x, count), chunk_at(x + w, count) + 1):
+            platform_lists[c].append(i)
+    for i, d in enumerate(level['decorations']):
+        decoration_lists[chunk_at(d[0], count)].append(i)
+
+    def flatten(lists):
+        start, index = [0], []
+        for l in lists:
+            index.extend(l)
+            start.append(len(index))
+        return start, index
+
+    return count, flatten(platform_lists), flatten(decoration_lists)
+
+
+def compile_level(level):
+    count, (p_start, p_index), (d_start, d_index) = build_chunks(level)
+    header_size = struct.calcsize(HEADER_FORMAT)
+    body = bytearray()
+
+    def add(data):
+        offset = header_size + len(body)
+        body.extend(data)
+        body.extend(b'\0' * (-len(body) % 4))
+        return offset
+
+    def ints(values):
+        return struct.pack('<%di' % len(values), *values)
+
+    name = level['name'].encode('utf-8')
+    name_offset = add(name)
+    platform_offset = add(ints([v for p in level['platforms'] for v in p]))
+    decoration_offset = add(ints([v for d in level['decorations'] for v in d]))
+    spawn_offset = add(ints([v for s in level['spawns'] for v in s]))
+    respawn_offset = add(ints([v for r in level['respawns'] for v in r]))
+    p_start_offset = add(ints(p_start))
+    p_index_offset = add(ints(p_index))
+    d_start_offset = add(ints(d_start))
+    d_index_offset = add(ints(d_index))
+
+    total = header_size + len(body)
+    header = struct.pack(
+        HEADER_FORMAT, MAGIC, VERSION, 0x01020304, total,
+        level['width'], level['height'],
+        level['item_range'][0], level['item_range'][1],
+        *level['intervals'],
+        CHUNK_WIDTH,
+        name_offset, len(name),
+        platform_offset, len(level['platforms']),
+        decoration_offset, len(level['decorations']),
+        spawn_offset, len(level['spawns']),
+        respawn_offset, len(level['respawns']),
+        count,
+        p_start_offset,
+        p_index_offset, len(p_index),
+        d_start_offset,
+        d_index_offset, len(d_index))
+    return header + bytes(body)
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.stderr.write('用法: levelc.py input.lvl output.lvb\n')
+        return 1
+    try:
+        blob = compile_level(parse(sys.argv[1]))
+    except LevelError as e:
+        sys.stderr.write('%s\n' % e)
+        return 1
+    with open(sys.argv[2], 'wb') as f:
+        f.write(blob)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())